@@ -13,8 +13,6 @@ void testApp::setup(){
 
 	cursor0.setup( iisuServer , iisuServer->addController() , ofColor( 0 , 255 , 0 ) ) ; 
 	cursor1.setup( iisuServer , iisuServer->addController() , ofColor( 0 , 0 , 255 ) ) ; 
-
-	iisuServer->initIisu() ; 
 #endif
 
 	Tweenzor::init() ; 
@@ -37,6 +35,8 @@ void testApp::update(){
 		return ; 
 	}
 
+	//Pick up the latest iisu frame before anything reads from the server
+	iisuServer->update( ) ; 
 	cursor0.update( ) ; 
 	cursor1.update( ) ; 
 
@@ -9,7 +9,6 @@ void testApp::setup(){
 	//Setup IISU server
 	iisuServer = new IisuServer( ) ; 
 	iisuServer->setup( false ) ; 
-	iisuServer->initIisu() ; 
 
 	userRep = IisuUserRepresentation() ; 
 	userRep.iisu = iisuServer ; 
@@ -29,6 +28,7 @@ void testApp::setup(){
     float length = 320-xInit; 
 
     drawPadding = false; 
+	bDrawProfiler = false ; 
     
     gui = new ofxUICanvas(0, 0, length+xInit, ofGetHeight());
 
@@ -42,6 +42,7 @@ void testApp::setup(){
 	gui->addWidgetDown(new ofxUILabelToggle( iisuSkeleton.bFlipX, "FLIP X", OFX_UI_FONT_MEDIUM)); 
 	gui->addWidgetDown(new ofxUILabelToggle( iisuSkeleton.bFlipY, "FLIP Y", OFX_UI_FONT_MEDIUM)); 
 	gui->addWidgetDown(new ofxUILabelToggle( iisuSkeleton.bEqualScaling , "EQUAL SCALING " , ofx_UI_FONT_MEDIUM ) ) ; 
+	gui->addWidgetDown(new ofxUILabelToggle( iisuSkeleton.bInterpolate , "INTERPOLATE" , OFX_UI_FONT_MEDIUM ) ) ; 
 	ofAddListener( gui->newGUIEvent,this,&testApp::guiEvent );	
 
 	gui->loadSettings( "GUI/iisuSkeleton.xml" ) ; 
@@ -60,6 +61,8 @@ void testApp::update(){
 		return ; 
 	}
 
+	//Pick up the latest iisu frame before anything reads from the server
+	iisuServer->update( ) ; 
 	iisuSkeleton.update ( ) ; 
 	userRep.update() ; 
 	
@@ -67,12 +70,19 @@ void testApp::update(){
 
 //--------------------------------------------------------------
 void testApp::draw(){
-	ofBackground ( 125 , 125 , 125 ) ; 
-	ofSetColor( 255 , 255 , 255 ) ; 
-	userRep.draw( ofGetWidth() - 170 , ofGetHeight() - 130 , 160 , 120 ) ; 
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_DRAW ) ; 
+		ofBackground ( 125 , 125 , 125 ) ; 
+		ofSetColor( 255 , 255 , 255 ) ; 
+		userRep.draw( ofGetWidth() - 170 , ofGetHeight() - 130 , 160 , 120 ) ; 
+
+		ofSetColor ( 255 , 255 , 255 ) ;
+		iisuSkeleton.draw( ) ;
+	}
 
-	ofSetColor ( 255 , 255 , 255 ) ;
-	iisuSkeleton.draw( ) ;
+	IisuProfiler::Instance()->markDrawn( iisuServer->getFrame() ) ; 
+	if ( bDrawProfiler ) 
+		IisuProfiler::Instance()->draw( ofGetWidth() - 420 , 20 ) ; 
 }
 
 void testApp::guiEvent(ofxUIEventArgs &e)
@@ -110,6 +120,11 @@ void testApp::guiEvent(ofxUIEventArgs &e)
 		iisuSkeleton.bFlipY = ((ofxUILabelToggle *) e.widget)->getValue() ; 
 	}
 
+	if(name ==  "INTERPOLATE" )
+	{
+		iisuSkeleton.bInterpolate = ((ofxUILabelToggle *) e.widget)->getValue() ; 
+	}
+
 	gui->saveSettings( "GUI/iisuSkeleton.xml" ) ; 
 
 }
@@ -118,6 +133,13 @@ void testApp::guiEvent(ofxUIEventArgs &e)
 		
 //--------------------------------------------------------------
 void testApp::keyPressed(int key){
+	//'p' toggles the latency overlay
+	if ( key == 'p' ) 
+	{
+		bDrawProfiler = !bDrawProfiler ; 
+		IisuProfiler::Instance()->setEnabled( bDrawProfiler ) ; 
+		IisuProfiler::Instance()->reset( ) ; 
+	}
 
 }
 
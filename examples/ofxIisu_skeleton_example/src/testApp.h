@@ -47,6 +47,7 @@ class testApp : public ofBaseApp{
 		ofxUICanvas *gui;   	
 		void guiEvent(ofxUIEventArgs &e);
 		bool drawPadding; 
+		bool bDrawProfiler ; 
 
 
 
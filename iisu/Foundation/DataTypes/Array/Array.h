@@ -4,10 +4,45 @@
 #include <assert.h>
 #include <vector>
 #include <bitset>
+#include <string.h>    // for memcpy
 #include <Platform/SkPlatform.h>
 
+// rvalue references : MSVC 2010 and up , gcc / clang in C++11 mode
+#if !defined(SK_HAS_RVALUE_REFERENCES)
+	#if (defined(_MSC_VER) && _MSC_VER >= 1600) || __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
+		#define SK_HAS_RVALUE_REFERENCES 1
+	#else
+		#define SK_HAS_RVALUE_REFERENCES 0
+	#endif
+#endif
+
+// compiler intrinsics , not every toolchain we ship for has <type_traits>
+#if defined(__clang__)
+	#define SK_IS_TRIVIALLY_COPYABLE(T) __is_trivially_copyable(T)
+#else
+	#define SK_IS_TRIVIALLY_COPYABLE(T) (__has_trivial_copy(T) && __has_trivial_assign(T))
+#endif
+
 namespace SK
 {
+	class Vector2;
+	class Vector3;
+
+	/**
+	* \struct	ArrayMemcpy
+	*
+	* \brief	Tells Array whether its elements can be copied with memcpy.
+	*
+	* True for trivially copyable types. Vector2 and Vector3 declare a copy constructor but only hold floats,
+	* specialize it for other plain types the same way.
+	*/
+
+	template<typename T>
+	struct ArrayMemcpy { enum { value = SK_IS_TRIVIALLY_COPYABLE(T) }; };
+
+	template<> struct ArrayMemcpy<Vector2> { enum { value = 1 }; };
+	template<> struct ArrayMemcpy<Vector3> { enum { value = 1 }; };
+
 	template<typename T>
 
 	/**
@@ -104,7 +139,7 @@ namespace SK
 			if(m_capacity != 0) 
 			{
 				m_values = new T[m_capacity];
-				for(size_t i = 0; i < m_size; ++i) m_values[i] = vect[i];
+				copyValues(m_values, &vect[0], m_size);
 			}
 		}
 
@@ -114,17 +149,63 @@ namespace SK
 		* \brief	Copy constructor.
 		*
 		* \param	other	The other array.
+		*
+		* Only allocates what other holds, not other's capacity.
 		*/
 
-		Array(const self_t& other):m_values(NULL), m_size(other.m_size), m_capacity(other.m_capacity)
+		Array(const self_t& other):m_values(NULL), m_size(other.m_size), m_capacity(other.m_size)
 		{
 			if(m_capacity != 0) 
 			{
 				m_values = new T[m_capacity];
-				for(size_t i = 0; i < m_size; ++i) m_values[i] = other.m_values[i];
+				copyValues(m_values, other.m_values, m_size);
 			}
 		}
 
+#if SK_HAS_RVALUE_REFERENCES
+
+		/**
+		* \fn	Array::Array(self_t&& other)
+		*
+		* \brief	Move constructor.
+		*
+		* \param	other	The array to take the values from, left empty.
+		*/
+
+		Array(self_t&& other):m_values(other.m_values), m_size(other.m_size), m_capacity(other.m_capacity)
+		{
+			other.m_values = NULL;
+			other.m_size = 0;
+			other.m_capacity = 0;
+		}
+
+		/**
+		* \fn	Array& Array::operator=(self_t&& other)
+		*
+		* \brief	Move assignment operator.
+		*
+		* \param	other	The array to take the values from, left empty.
+		*
+		* \return	This array.
+		*/
+
+		Array& operator=(self_t&& other)
+		{
+			if (this != &other)
+			{
+				destroy();
+				m_values = other.m_values;
+				m_size = other.m_size;
+				m_capacity = other.m_capacity;
+				other.m_values = NULL;
+				other.m_size = 0;
+				other.m_capacity = 0;
+			}
+			return *this;
+		}
+
+#endif
+
 		/**
 		* \fn	Array::~Array()
 		*
@@ -145,11 +226,20 @@ namespace SK
 		*
 		* \param	other	The array to be copied.
 		*
-		* \return	A shallow copy of this object.
+		* \return	This array.
+		*
+		* Reuses the current buffer when other fits in its capacity.
 		*/
 
 		Array& operator=(const self_t& other)
 		{
+			if (this == &other) return *this;
+			if (other.m_size <= m_capacity)
+			{
+				copyValues(m_values, other.m_values, other.m_size);
+				m_size = other.m_size;
+				return *this;
+			}
 			Array tmp = other;
 			swap(tmp);
 			return *this;
@@ -162,11 +252,19 @@ namespace SK
 		*
 		* \param	vect	The vector to be copied.
 		*
-		* \return	A shallow copy of this vector.
+		* \return	This array.
+		*
+		* Reuses the current buffer when vect fits in its capacity.
 		*/
 
 		Array& operator=(const std::vector<T>& vect)
 		{
+			if (vect.size() <= m_capacity)
+			{
+				if (!vect.empty()) copyValues(m_values, &vect[0], (size_t) vect.size());
+				m_size = (size_t) vect.size();
+				return *this;
+			}
 			Array tmp = vect;
 			swap(tmp);
 			return *this;
@@ -268,8 +366,7 @@ namespace SK
 				values = new T[capacity];
 				if (preserve)
 				{
-					for(size_t i = 0; i<m_size; ++i)
-						values[i] = m_values[i];
+					copyValues(values, m_values, m_size);
 				}
 			}
 			delete[] m_values;
@@ -382,11 +479,28 @@ namespace SK
 		operator std::vector<T>()const
 		{
 			std::vector<T> ret(m_size);
-			for(size_t i = 0; i < m_size; ++i) ret[i] = m_values[i];
+			if (m_size != 0) copyValues(&ret[0], m_values, m_size);
 			return ret;
 		}
 
 	private:
+
+		template<int> struct CopyTag {};
+
+		static void copyValues(T* destination, const T* source, size_t count)
+		{
+			copyValues(destination, source, count, CopyTag<ArrayMemcpy<T>::value>());
+		}
+
+		static void copyValues(T* destination, const T* source, size_t count, CopyTag<1>)
+		{
+			if (count != 0) memcpy((void*)destination, (const void*)source, count * sizeof(T));
+		}
+
+		static void copyValues(T* destination, const T* source, size_t count, CopyTag<0>)
+		{
+			for(size_t i = 0; i < count; ++i) destination[i] = source[i];
+		}
 	
 		void swap(self_t& other)
 		{
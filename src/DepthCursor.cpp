@@ -3,42 +3,53 @@
 	
 void DepthCursor::setup ( IisuServer * _iisu , int _cursorID , ofColor _color ) 
 {
+	//setup() again with another ID moves us in the cursor table
+	IisuEvents::Instance()->removeCursorListener( cursorID , this ) ; 
+
 	bActive = false ; 
 	iisu = _iisu ; 
+	subscription.set( iisu , IISU_STREAM_CONTROLLERS ) ; 
 	color = _color ; 
 	cursorID = _cursorID ; 
 	cursorStatus = 0 ; 
 	position = ofVec3f () ; 
 	bDebugDraw = false ; 	
-	ofAddListener( IisuEvents::Instance()->CURSOR_DETECTED , this , &DepthCursor::cursorFoundHandler ) ; 
-	ofAddListener( IisuEvents::Instance()->CURSOR_LOST , this , &DepthCursor::cursorLostHandler ) ; 
-	ofAddListener( IisuEvents::Instance()->CURSOR_DESTROYED , this , &DepthCursor::cursorDestroyedHandler ) ;
+	if ( isControllerCursor() ) 
+		IisuEvents::Instance()->addCursorListener( cursorID , this ) ; 
+	smoother.setup( 2 ) ; 
 }
 
 void DepthCursor::update( ) 
 {
+	IISU_PROFILE_SCOPE( IISU_STAGE_CURSOR_UPDATE ) ; 
 	cursorStatus = iisu->getCursorStatus( cursorID ) ; 
 
+	if ( viewportChanged() ) 
+	{
+		//Limit positions so that the cursor never goes off of the edge
+		mapper = IisuCoordinateMapper::iisuPointToOF( viewportWidth , viewportHeight ) ; 
+		mapper.setClamp( edgePadding , edgePadding , viewportWidth - edgePadding , viewportHeight - edgePadding ) ; 
+	}
+
 	//Calculate the palm position
-	ofVec3f desiredLoc = IisuUtils::Instance()->iisuPointToOF( iisu->getNormalizedCursorCoordinates( cursorID ) ) ; 
-	
-	//Limit positions so that the cursor never goes off of the edge
-	float padding = 50 ; 
-	float maxX = ofGetWidth() - padding ; 
-	float maxY = ofGetHeight() - padding ; 
+	ofVec3f desiredLoc = mapper.map( iisu->getNormalizedCursorCoordinates( cursorID ) ) ; 
 
-	if ( desiredLoc.x < padding ) 
-		desiredLoc.x = padding ; 
-	if ( desiredLoc.x > maxX )
-		desiredLoc.x = maxX ; 
+	//Smoothed by the time between frames , not by how often update() runs
+	float xy[2] = { desiredLoc.x , desiredLoc.y } ; 
+	smoother.filter( xy , 0 , 2 , iisu->getFrame().timestamp ) ; 
+	position.set( xy[0] , xy[1] , desiredLoc.z ) ; 
+}
 
-	if ( desiredLoc.y < padding ) 
-		desiredLoc.y = padding ; 
-	if ( desiredLoc.y > maxY ) 
-		desiredLoc.y = maxY ; 
+bool DepthCursor::viewportChanged( ) 
+{
+	float width = ofGetWidth() ; 
+	float height = ofGetHeight() ; 
+	if ( width == viewportWidth && height == viewportHeight ) 
+		return false ; 
 
-	//A little interpolation goes a long way to make it look smoother
-	position = position.interpolate( desiredLoc , 0.5 ) ; 
+	viewportWidth = width ; 
+	viewportHeight = height ; 
+	return true ; 
 }
 
 void DepthCursor::draw ( ) 
@@ -63,18 +74,18 @@ void DepthCursor::debugDraw( )
 
 
 
-void DepthCursor::cursorFoundHandler ( int &args ) 
+void DepthCursor::cursorFoundHandler ( int id ) 
 {
 	bActive = true ; 
-	cout << "cursor " << cursorID << " found ! " << endl ;
 }
 
-void DepthCursor::cursorLostHandler ( int &args ) 
+void DepthCursor::cursorLostHandler ( int id ) 
 {
-	cout << "cursor " << cursorID << " lost ! " << endl ;
+	bActive = false ; 
 }
 
-void DepthCursor::cursorDestroyedHandler ( int &args ) 
+void DepthCursor::cursorDestroyedHandler ( int id ) 
 {
-	cout << "cursor " << cursorID << " destroyed ! " << endl ;
+	bActive = false ; 
+	cursorStatus = 0 ; 
 }
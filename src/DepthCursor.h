@@ -3,12 +3,23 @@
 #include "ofMain.h" 
 #include "IisuServer.h"
 #include "IisuEvents.h"
+#include "IisuFilter.h"
 
-class DepthCursor 
+class DepthCursor : public IisuCursorListener
 {
 	public :
 		DepthCursor() {
 			iisu = NULL ; 
+			cursorID = -1 ; 
+			viewportWidth = 0 ; 
+			viewportHeight = 0 ; 
+			edgePadding = 50 ; 
+		}
+
+		//Gives our slot in IisuEvents' cursor table back
+		virtual ~DepthCursor( ) 
+		{
+			IisuEvents::Instance()->removeCursorListener( cursorID , this ) ; 
 		}
 		
 		virtual void setup ( IisuServer * _iisu , int _cursorID , ofColor _color ) ;
@@ -16,18 +27,31 @@ class DepthCursor
 		virtual void draw ( ) ;
 		virtual void debugDraw( ) ; 
 
-		//Iisu cursor changes
-		void cursorFoundHandler ( int &args ) ;
-		void cursorLostHandler ( int &args ) ;
-		void cursorDestroyedHandler ( int &args ) ; 
+		//Iisu cursor changes , only for our cursorID
+		virtual void cursorFoundHandler ( int cursorID ) ;
+		virtual void cursorLostHandler ( int cursorID ) ;
+		virtual void cursorDestroyedHandler ( int cursorID ) ; 
+
+		//Only UI.CONTROLLER cursors go into IisuEvents' cursor table , cursors with another kind of ID say no
+		virtual bool isControllerCursor( ) { return true ; }
 		
 		bool bActive ; 
 		int cursorID ;			//iisu ID
 		int cursorStatus ;		//found, lost, out of bounds  // LOOK UP ENUM VALUES
 		ofVec3f position ;		//Screen / Window Coordinates	
+
+		//Filters position by iisu frame time , see IisuFilterBank
+		IisuFilterBank smoother ; 
 		ofColor color ;			
 
 		IisuServer * iisu ; 
+		IisuSubscription subscription ;		//UI.CONTROLLER# , HandCursor adds CI.HAND#
 		bool bDebugDraw ; 
 
+		//iisu -> window mapping , only rebuilt when the window size changes
+		IisuCoordinateMapper mapper ; 
+		float edgePadding ;				//keeps the cursor this far from the window edges
+		bool viewportChanged( ) ; 
+		float viewportWidth , viewportHeight ; 
+
 };
\ No newline at end of file
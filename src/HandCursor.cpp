@@ -4,6 +4,7 @@ void HandCursor::setup( IisuServer * iisu , int cursorID , ofColor _color )
 {
 	//Initialize everything the same as DepthCursor
 	DepthCursor::setup( iisu , cursorID , _color ) ; 
+	subscription.set( iisu , IISU_STREAM_CONTROLLERS | IISU_STREAM_HANDS ) ; 
 	int numFingers = 5 ; 
 	activeFingers = 0 ; 
 
@@ -13,6 +14,10 @@ void HandCursor::setup( IisuServer * iisu , int cursorID , ofColor _color )
 		finger->setup( i , 3 , ofColor::fromHsb( i * .2f * 255.0f , 255 , 255 ) ) ; 
 		fingers.push_back( finger ) ; 
 	}
+	fingerX.resize( numFingers ) ; 
+	fingerY.resize( numFingers ) ; 
+	channels.resize( 5 + numFingers * 2 ) ; 
+	smoother.setup( channels.size() ) ; 
 
 	bOpen = false ; 
 	openAmount = 1.0f ; 
@@ -22,6 +27,7 @@ void HandCursor::setup( IisuServer * iisu , int cursorID , ofColor _color )
 
 void HandCursor::update ( ) 
 {
+	IISU_PROFILE_SCOPE( IISU_STAGE_CURSOR_UPDATE ) ; 
 	activeFingers = 0 ; 
 	if ( iisu->getHandStatus( cursorID ) > 0 ) 
 	{
@@ -42,35 +48,53 @@ void HandCursor::update ( )
 			}
 		}
 
-		//Interpolate it just a little bit
-		openAmount =  ofLerp( openAmount , iisu->getHandsOpenAmount( cursorID ) , 0.5f ) ; 
-
 		bActive = true ;
 
 		float xSensitivity = 1.0f ; 
 		float ySensitivity = 2.0f ; 
 
+		if ( viewportChanged() ) 
+			handMapper = IisuCoordinateMapper::normalize2DPoint( 320 , 240 , true , false , viewportWidth , viewportHeight ) ; 
+
 		//Calculate the palm position
-		ofVec2f desiredLoc =  IisuUtils::Instance()->Vector2DToPoint( IisuUtils::Instance()->normalize2DPoint( iisu->getHandPalmPosition2D( cursorID ) , 320 , 240 , true ) ) ;
-		desiredLoc.x *= ofGetWidth() ; 
-		desiredLoc.y *= ofGetHeight() ; 
+		ofVec2f desiredLoc = handMapper.map( iisu->getHandPalmPosition2D( cursorID ) ) ;
 
 		//Calculate the hand tip
-		ofVec2f desiredHandTip = IisuUtils::Instance()->Vector2DToPoint( IisuUtils::Instance()->normalize2DPoint( iisu->getHandTipPosition2D( cursorID ) , 320 , 240 , true ) ) ;
-		desiredHandTip.x *= ofGetWidth() ; 
-		desiredHandTip.y *= ofGetHeight() ; 
+		ofVec2f desiredHandTip = handMapper.map( iisu->getHandTipPosition2D( cursorID ) ) ;
 
-		position = desiredLoc ;
-		handTipPosition = desiredHandTip ; 
+		channels[0] = desiredLoc.x ; 
+		channels[1] = desiredLoc.y ; 
+		channels[2] = desiredHandTip.x ; 
+		channels[3] = desiredHandTip.y ; 
+		channels[4] = iisu->getHandsOpenAmount( cursorID ) ; 
+		double time = iisu->getFrame().timestamp ; 
+		smoother.filter( &channels[0] , 0 , 5 , time ) ; 
+
+		position.set( channels[0] , channels[1] , 0 ) ; 
+		handTipPosition.set( channels[2] , channels[3] ) ; 
+		openAmount = channels[4] ; 
 
 		if ( fingers.size() > 0 ) 
 		{
-			SK::Array<int32_t> fingerStatus = iisu->getHandsFingerTipsStatus( cursorID ) ; 
-			SK::Array<Vector2> fingerPositions2D = iisu->getHandsFingerTips2D( cursorID ) ;
+			//Views into the current frame , nothing is copied
+			IisuArrayView<int32_t> fingerStatus = iisu->getHandFingerTipsStatusView( cursorID ) ; 
+			IisuArrayView<Vector2> fingerPositions2D = iisu->getHandFingerTips2DView( cursorID ) ; 
 
 			if ( fingerStatus.size() == 0 && fingerPositions2D.size() == 0 ) 
 				return ; 
 
+			//All the finger tips in one go
+			int numTips = MIN( fingerPositions2D.size() , fingers.size() ) ; 
+			if ( numTips > 0 ) 
+				handMapper.map( &fingerPositions2D[0] , numTips , &fingerX[0] , &fingerY[0] ) ; 
+
+			for ( int f = 0 ; f < fingers.size() ; f++ ) 
+			{
+				channels[ 5 + f * 2 ] = fingerX[f] ; 
+				channels[ 6 + f * 2 ] = fingerY[f] ; 
+			}
+			smoother.filter( &channels[5] , 5 , fingers.size() * 2 , time ) ; 
+
 			
 			for ( int f = 0 ; f < fingers.size() ; f++ ) 
 			{ 
@@ -97,9 +121,7 @@ void HandCursor::update ( )
 					ofLog( OF_LOG_VERBOSE,  " finger# " + ofToString( f ) + " was : " + lastStatusString + " is now : " + newStatusString ) ;  
 				}
 					
-				ofVec2f desiredFingerLoc = IisuUtils::Instance()->Vector2DToPoint( fingerPositions2D[ f ] ) ;
-				desiredFingerLoc.x = ( 1.0f - ( desiredFingerLoc.x / 320.0f ) ) * ofGetWidth() ; 
-				desiredFingerLoc.y = ( ( desiredFingerLoc.y / 240.0f ) ) * ofGetHeight() ; 
+				ofVec2f desiredFingerLoc = ofVec2f( channels[ 5 + f * 2 ] , channels[ 6 + f * 2 ] ) ;
 
 				(fingers[f])->radius = 8.0f ; // ( 0.9f - normalZ ) * 40.0f ; 
 				(fingers[f])->position = desiredFingerLoc ; 
@@ -15,6 +15,9 @@ class HandCursor : public DepthCursor
 		void draw ( ) ; 
 		void debugDraw( ) ; 
 
+		//cursorID is a CI hand , a controller with the same index keeps its cursor events
+		bool isControllerCursor( ) { return false ; }
+
 		vector<HandCursorFinger*> fingers ;   
 		
 		float zFactor ; 
@@ -25,4 +28,11 @@ class HandCursor : public DepthCursor
 		bool bOpen ; 
 		float openAmount ; 
 		float handOpenThreshold ; 
+
+		//CI positions come in 320 x 240 camera pixels , palm , tip and fingers share one mapping
+		IisuCoordinateMapper handMapper ; 
+		vector<float> fingerX , fingerY ; 
+
+		//palm x y , tip x y , open amount , then every finger x and y , smoothed together
+		vector<float> channels ; 
 };
\ No newline at end of file
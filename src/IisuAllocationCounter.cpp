@@ -0,0 +1,53 @@
+#include "IisuAllocationCounter.h"
+
+#ifdef IISU_COUNT_ALLOCATIONS
+
+#include <new>
+#include <stdlib.h>
+
+#ifdef _MSC_VER
+#define IISU_THREAD_LOCAL __declspec( thread )
+#else
+#define IISU_THREAD_LOCAL __thread
+#endif
+
+static IISU_THREAD_LOCAL int threadAllocations = 0 ; 
+static IISU_THREAD_LOCAL bool bThreadCounting = false ; 
+
+static void * countedAlloc( size_t size ) 
+{
+	if ( bThreadCounting ) 
+		threadAllocations++ ; 
+
+	void * p = malloc( size > 0 ? size : 1 ) ; 
+	if ( p == NULL ) 
+		throw std::bad_alloc( ) ; 
+	return p ; 
+}
+
+void * operator new( size_t size ) { return countedAlloc( size ) ; } 
+void * operator new[]( size_t size ) { return countedAlloc( size ) ; } 
+void operator delete( void * p ) throw() { free( p ) ; } 
+void operator delete[]( void * p ) throw() { free( p ) ; } 
+
+bool IisuAllocationCounter::isEnabled( ) { return true ; } 
+
+void IisuAllocationCounter::begin( ) 
+{
+	threadAllocations = 0 ; 
+	bThreadCounting = true ; 
+}
+
+int IisuAllocationCounter::end( ) 
+{
+	bThreadCounting = false ; 
+	return threadAllocations ; 
+}
+
+#else
+
+bool IisuAllocationCounter::isEnabled( ) { return false ; } 
+void IisuAllocationCounter::begin( ) { } 
+int IisuAllocationCounter::end( ) { return 0 ; } 
+
+#endif
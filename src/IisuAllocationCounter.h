@@ -0,0 +1,17 @@
+#pragma once
+
+/*
+	IisuAllocationCounter
+	Counts heap allocations made by the calling thread between begin() and end().
+	It only counts when the addon is built with IISU_COUNT_ALLOCATIONS defined , which swaps in
+	a global operator new. Meant for checking that the steady state frame path never allocates.
+*/
+
+class IisuAllocationCounter
+{
+	public :
+		static bool isEnabled( ) ; 
+
+		static void begin( ) ; 
+		static int end( ) ;				//allocations since begin() on this thread
+};
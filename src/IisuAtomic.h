@@ -0,0 +1,72 @@
+#pragma once
+
+/*
+	Minimal atomic helpers for the lock-free parts of the addon.
+	Not every compiler we build with ships <atomic> so these wrap the Interlocked / __sync intrinsics.
+	Every call is a full memory barrier.
+*/
+
+#ifdef WIN32
+#include <windows.h>
+
+typedef volatile LONG iisu_atomic_t ; 
+
+inline long iisuAtomicLoad( iisu_atomic_t * target ) 
+{
+	return InterlockedCompareExchange( target , 0 , 0 ) ; 
+}
+
+inline void iisuAtomicStore( iisu_atomic_t * target , long value ) 
+{
+	InterlockedExchange( target , value ) ; 
+}
+
+//Returns the previous value
+inline long iisuAtomicExchange( iisu_atomic_t * target , long value ) 
+{
+	return InterlockedExchange( target , value ) ; 
+}
+
+//Returns the new value
+inline long iisuAtomicAdd( iisu_atomic_t * target , long value ) 
+{
+	return InterlockedExchangeAdd( target , value ) + value ; 
+}
+
+inline bool iisuAtomicCompareAndSwap( iisu_atomic_t * target , long expected , long desired ) 
+{
+	return ( InterlockedCompareExchange( target , desired , expected ) == expected ) ; 
+}
+
+#else
+
+typedef volatile long iisu_atomic_t ; 
+
+inline long iisuAtomicLoad( iisu_atomic_t * target ) 
+{
+	return __sync_val_compare_and_swap( target , 0 , 0 ) ; 
+}
+
+inline long iisuAtomicExchange( iisu_atomic_t * target , long value ) 
+{
+	//__sync_lock_test_and_set is only an acquire barrier
+	__sync_synchronize( ) ; 
+	return __sync_lock_test_and_set( target , value ) ; 
+}
+
+inline void iisuAtomicStore( iisu_atomic_t * target , long value ) 
+{
+	iisuAtomicExchange( target , value ) ; 
+}
+
+inline long iisuAtomicAdd( iisu_atomic_t * target , long value ) 
+{
+	return __sync_add_and_fetch( target , value ) ; 
+}
+
+inline bool iisuAtomicCompareAndSwap( iisu_atomic_t * target , long expected , long desired ) 
+{
+	return __sync_bool_compare_and_swap( target , expected , desired ) ; 
+}
+
+#endif
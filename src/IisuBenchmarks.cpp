@@ -0,0 +1,257 @@
+#include "IisuBenchmarks.h"
+#include "IisuUserMask.h"
+#include "IisuUtils.h"
+#include "IisuContour.h"
+
+void IisuBenchmarks::makeLabelImage( vector<unsigned char> &labels , int width , int height , int userID ) 
+{
+	labels.assign( width * height , 0 ) ; 
+	ofSeedRandom( 9 ) ; 
+	for ( int y = 0 ; y < height ; y++ ) 
+	{
+		for ( int x = 0 ; x < width ; x++ ) 
+		{
+			unsigned char value = 0 ; 
+			float dx = ( x - width * 0.5f ) / ( width * 0.15f ) ; 
+			float dy = ( y - height * 0.55f ) / ( height * 0.4f ) ; 
+			if ( dx * dx + dy * dy < 1.0f ) 
+				value = (unsigned char) userID ; 
+			else if ( x < width / 5 ) 
+				value = 251 ;					//wall
+			else if ( ofRandom( 1.0f ) < 0.02f ) 
+				value = (unsigned char) ofRandom( 10 , 20 ) ;			//clutter
+			labels[ y * width + x ] = value ; 
+		}
+	}
+}
+
+//The loop IisuUserRepresentation::update used to run every frame
+static void legacyUserMask( const unsigned char * labels , unsigned char * pixels , int totalPixels , int userValue , int lastUserID ) 
+{
+	memcpy( pixels , labels , totalPixels ) ; 
+	if ( userValue < 250 ) 
+	{
+		for ( int i = 0 ; i < totalPixels ; i++ ) 
+		{
+			unsigned char value = pixels[i] ; 
+			if ( value != userValue && value != lastUserID ) 
+				pixels[i] = 0 ; 
+			else
+				pixels[i] = 255 ; 
+		}
+	}
+	else
+	{
+		for ( int i = 0 ; i < totalPixels ; i++ ) 
+			pixels[i] = 0 ; 
+	}
+}
+
+void IisuBenchmarks::userMask( int iterations ) 
+{
+	int sizes[3][2] = { { 160 , 120 } , { 320 , 240 } , { 640 , 480 } } ; 
+	int userID = 3 ; 
+	int lastUserID = 7 ; 
+
+	cout << "IisuBenchmarks::userMask , " << iterations << " iterations , best available : " << IisuCpu::getSimdName( IisuCpu::getSimdLevel() ) << endl ; 
+
+	for ( int s = 0 ; s < 3 ; s++ ) 
+	{
+		int width = sizes[s][0] ; 
+		int height = sizes[s][1] ; 
+		int totalPixels = width * height ; 
+
+		vector<unsigned char> labels ; 
+		makeLabelImage( labels , width , height , userID ) ; 
+		vector<unsigned char> legacyPixels( totalPixels ) ; 
+		vector<unsigned char> mask( totalPixels ) ; 
+		IisuUserMaskResult result ; 
+
+		unsigned long long start = ofGetElapsedTimeMicros() ; 
+		for ( int i = 0 ; i < iterations ; i++ ) 
+			legacyUserMask( &labels[0] , &legacyPixels[0] , totalPixels , userID , lastUserID ) ; 
+		double legacyMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+		cout << "  " << width << "x" << height << "  legacy loop : " << legacyMicros << " us" ; 
+
+		for ( int level = IISU_SIMD_SCALAR ; level <= IisuCpu::getSimdLevel() ; level++ ) 
+		{
+			start = ofGetElapsedTimeMicros() ; 
+			for ( int i = 0 ; i < iterations ; i++ ) 
+				IisuUserMask::extract( &labels[0] , width , height , userID , lastUserID , &mask[0] , result , (IisuSimdLevel) level ) ; 
+			double micros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+			bool bSame = ( memcmp( &mask[0] , &legacyPixels[0] , totalPixels ) == 0 ) ; 
+			cout << "  " << IisuCpu::getSimdName( (IisuSimdLevel) level ) << " : " << micros << " us" << ( bSame ? "" : " ( MISMATCH )" ) ; 
+		}
+		cout << "  user pixels : " << result.numUserPixels << " bounds : " << result.minX << "," << result.minY << " - " << result.maxX << "," << result.maxY << endl ; 
+	}
+}
+
+static double pointsPerSecond( int numPoints , int iterations , unsigned long long micros ) 
+{
+	return ( micros > 0 ) ? ( (double) numPoints * iterations * 1000000.0 / micros ) : 0.0 ; 
+}
+
+void IisuBenchmarks::coordinateMapping( int numPoints , int iterations ) 
+{
+	float width = ofGetWidth() ; 
+	float height = ofGetHeight() ; 
+	float padding = 0.2f ; 
+
+	vector<Vector3> points3D( numPoints ) ; 
+	vector<Vector2> points2D( numPoints ) ; 
+	ofSeedRandom( 9 ) ; 
+	for ( int i = 0 ; i < numPoints ; i++ ) 
+	{
+		points3D[i] = Vector3( ofRandom( -1.2f , 1.2f ) , ofRandom( 0.5f , 4.0f ) , ofRandom( -1.2f , 1.2f ) ) ; 
+		points2D[i] = Vector2( points3D[i].x , points3D[i].z ) ; 
+	}
+
+	vector<ofVec3f> legacy3D( numPoints ) ; 
+	vector<ofVec2f> legacy2D( numPoints ) ; 
+	vector<float> x( numPoints ) , y( numPoints ) , z( numPoints ) ; 
+
+	cout << "IisuBenchmarks::coordinateMapping , " << numPoints << " points x " << iterations << " iterations" << endl ; 
+
+	//3D
+	unsigned long long start = ofGetElapsedTimeMicros() ; 
+	for ( int n = 0 ; n < iterations ; n++ ) 
+		for ( int i = 0 ; i < numPoints ; i++ ) 
+			legacy3D[i] = IisuUtils::Instance()->iisuPosition3DToOfxScreen( points3D[i] , padding , true , true ) ; 
+	cout << "  Vector3 per point : " << pointsPerSecond( numPoints , iterations , ofGetElapsedTimeMicros() - start ) << " points/s" ; 
+
+	IisuCoordinateMapper mapper3D = IisuCoordinateMapper::iisuPosition3DToOfxScreen( width , height , padding , true , true ) ; 
+	for ( int level = IISU_SIMD_SCALAR ; level <= MIN( IisuCpu::getSimdLevel() , IISU_SIMD_SSE2 ) ; level++ ) 
+	{
+		start = ofGetElapsedTimeMicros() ; 
+		for ( int n = 0 ; n < iterations ; n++ ) 
+			mapper3D.map( &points3D[0] , numPoints , &x[0] , &y[0] , &z[0] , (IisuSimdLevel) level ) ; 
+		unsigned long long micros = ofGetElapsedTimeMicros() - start ; 
+
+		float maxError = 0.0f ; 
+		for ( int i = 0 ; i < numPoints ; i++ ) 
+			maxError = MAX( maxError , fabs( x[i] - legacy3D[i].x ) + fabs( y[i] - legacy3D[i].y ) + fabs( z[i] - legacy3D[i].z ) ) ; 
+		cout << "  " << IisuCpu::getSimdName( (IisuSimdLevel) level ) << " : " << pointsPerSecond( numPoints , iterations , micros ) << " points/s ( max error " << maxError << " )" ; 
+	}
+	cout << endl ; 
+
+	//2D
+	start = ofGetElapsedTimeMicros() ; 
+	for ( int n = 0 ; n < iterations ; n++ ) 
+		for ( int i = 0 ; i < numPoints ; i++ ) 
+			legacy2D[i] = IisuUtils::Instance()->iisuPosition2DToOfxScreen( points2D[i] , padding , true , true ) ; 
+	cout << "  Vector2 per point : " << pointsPerSecond( numPoints , iterations , ofGetElapsedTimeMicros() - start ) << " points/s" ; 
+
+	IisuCoordinateMapper mapper2D = IisuCoordinateMapper::iisuPosition2DToOfxScreen( width , height , padding , true , true ) ; 
+	for ( int level = IISU_SIMD_SCALAR ; level <= MIN( IisuCpu::getSimdLevel() , IISU_SIMD_SSE2 ) ; level++ ) 
+	{
+		start = ofGetElapsedTimeMicros() ; 
+		for ( int n = 0 ; n < iterations ; n++ ) 
+			mapper2D.map( &points2D[0] , numPoints , &x[0] , &y[0] , (IisuSimdLevel) level ) ; 
+		unsigned long long micros = ofGetElapsedTimeMicros() - start ; 
+
+		float maxError = 0.0f ; 
+		for ( int i = 0 ; i < numPoints ; i++ ) 
+			maxError = MAX( maxError , fabs( x[i] - legacy2D[i].x ) + fabs( y[i] - legacy2D[i].y ) ) ; 
+		cout << "  " << IisuCpu::getSimdName( (IisuSimdLevel) level ) << " : " << pointsPerSecond( numPoints , iterations , micros ) << " points/s ( max error " << maxError << " )" ; 
+	}
+	cout << endl ; 
+}
+
+
+void IisuBenchmarks::contours( int iterations ) 
+{
+	int sizes[3][2] = { { 160 , 120 } , { 320 , 240 } , { 640 , 480 } } ; 
+	int userID = 3 ; 
+
+	cout << "IisuBenchmarks::contours , " << iterations << " iterations" << endl ; 
+
+	for ( int s = 0 ; s < 3 ; s++ ) 
+	{
+		int width = sizes[s][0] ; 
+		int height = sizes[s][1] ; 
+
+		vector<unsigned char> labels ; 
+		makeLabelImage( labels , width , height , userID ) ; 
+		vector<unsigned char> mask( width * height ) ; 
+		IisuUserMaskResult result ; 
+		IisuUserMask::extract( &labels[0] , width , height , userID , userID , &mask[0] , result ) ; 
+
+		IisuContourTracer tracer ; 
+		unsigned long long start = ofGetElapsedTimeMicros() ; 
+		for ( int i = 0 ; i < iterations ; i++ ) 
+			tracer.trace( &mask[0] , width , height ) ; 
+		double traceMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+		start = ofGetElapsedTimeMicros() ; 
+		for ( int i = 0 ; i < iterations ; i++ ) 
+			tracer.simplify( 1.5f ) ; 
+		double simplifyMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+		cout << "  " << width << "x" << height << "  trace : " << traceMicros << " us  simplify : " << simplifyMicros << " us" 
+			 << "  contours : " << tracer.contours.size() << " points : " << tracer.points.size() << " -> " << tracer.simplifiedPoints.size() << endl ; 
+	}
+}
+
+void IisuBenchmarks::iisuArrays( int iterations ) 
+{
+	cout << "IisuBenchmarks::iisuArrays , " << iterations << " iterations" << endl ; 
+
+	//As many as USER1.SHAPE.CENTROIDS.Positions holds
+	SK::Array<SK::Vector3> centroids( 150 ) ; 
+	for ( int i = 0 ; i < 150 ; i++ ) 
+		centroids[i] = SK::Vector3( i * 0.01f , 1.0f - i * 0.005f , 2.0f ) ; 
+
+	//What every assignment used to cost : a new buffer and a copy
+	unsigned long long start = ofGetElapsedTimeMicros() ; 
+	float checksum = 0.0f ; 
+	for ( int i = 0 ; i < iterations ; i++ ) 
+	{
+		SK::Array<SK::Vector3> copy( centroids ) ; 
+		checksum += copy[ i % 150 ].x ; 
+	}
+	double copyMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+	SK::Array<SK::Vector3> destination ; 
+	destination = centroids ; 
+	start = ofGetElapsedTimeMicros() ; 
+	for ( int i = 0 ; i < iterations ; i++ ) 
+	{
+		destination = centroids ; 
+		checksum += destination[ i % 150 ].x ; 
+	}
+	double assignMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+	double moveMicros = 0.0 ; 
+#if SK_HAS_RVALUE_REFERENCES
+	start = ofGetElapsedTimeMicros() ; 
+	for ( int i = 0 ; i < iterations ; i++ ) 
+	{
+		SK::Array<SK::Vector3> moved( std::move( destination ) ) ; 
+		destination = std::move( moved ) ; 
+	}
+	moveMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+#endif
+
+	cout << "  Array<Vector3> x 150  copy : " << copyMicros << " us  assign : " << assignMicros << " us  move : " << moveMicros << " us" << endl ; 
+
+	//Label image sized
+	SK::ImageInfos infos( 320 , 240 , 1 , SK::ImageInfos::IMAGE_DEPTH_8U ) ; 
+	SK::Image source( infos ) ; 
+	source.reset( 3 ) ; 
+	SK::Image image( infos ) ; 
+
+	start = ofGetElapsedTimeMicros() ; 
+	for ( int i = 0 ; i < iterations ; i++ ) 
+		image = source ; 
+	double imageAssignMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+	start = ofGetElapsedTimeMicros() ; 
+	for ( int i = 0 ; i < iterations ; i++ ) 
+		SK::copyImage( &source , &image ) ; 
+	double imageCopyMicros = (double) ( ofGetElapsedTimeMicros() - start ) / iterations ; 
+
+	cout << "  Image 320x240  operator= : " << imageAssignMicros << " us  copyImage : " << imageCopyMicros << " us" 
+		 << "  ( checksum " << checksum + image.getRAW()[0] << " )" << endl ; 
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+/*
+	IisuBenchmarks
+	Timing runs for the hot loops , on synthetic data so they work without a camera.
+	Call them from an app's setup() and read the results on the console.
+*/
+
+#include "ofMain.h"
+
+class IisuBenchmarks
+{
+	public :
+		//Old per-pixel user loop against every mask kernel this machine supports , at 160x120 , 320x240 and 640x480
+		static void userMask( int iterations = 500 ) ; 
+
+		//Per point IisuUtils calls against IisuCoordinateMapper batches , reported in points per second
+		static void coordinateMapping( int numPoints = 4096 , int iterations = 200 ) ; 
+
+		//IisuContourTracer trace + simplify on the user mask at 160x120 , 320x240 and 640x480
+		static void contours( int iterations = 500 ) ; 
+
+		//SK::Array<Vector3> of 150 centroids : copy into a new buffer against assigning into one that fits and moving ,
+		//and a 320x240 SK::Image through operator= against copyImage() into an existing buffer
+		static void iisuArrays( int iterations = 20000 ) ; 
+
+	protected :
+		//Label image with a background , a few other objects and one user blob
+		static void makeLabelImage( vector<unsigned char> &labels , int width , int height , int userID ) ; 
+};
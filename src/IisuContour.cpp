@@ -0,0 +1,236 @@
+#include "IisuContour.h"
+
+//Neighbours clockwise on screen ( y goes down ) starting east : E , SE , S , SW , W , NW , N , NE
+static const int neighbourX[8] = { 1 , 1 , 0 , -1 , -1 , -1 , 0 , 1 } ; 
+static const int neighbourY[8] = { 0 , 1 , 1 , 1 , 0 , -1 , -1 , -1 } ; 
+
+void IisuContourTracer::trace( const unsigned char * mask , int _width , int _height ) 
+{
+	width = _width ; 
+	height = _height ; 
+	stride = width + 2 ; 
+
+	contours.clear() ; 
+	points.clear() ; 
+	borderIsHole.clear() ; 
+	borderContour.clear() ; 
+	borderParent.clear() ; 
+
+	//Border 0 is unused , 1 is the image frame which counts as a hole around everything
+	borderIsHole.push_back( 0 ) ; borderContour.push_back( -1 ) ; borderParent.push_back( -1 ) ; 
+	borderIsHole.push_back( 1 ) ; borderContour.push_back( -1 ) ; borderParent.push_back( -1 ) ; 
+
+	borders.assign( stride * ( height + 2 ) , 0 ) ; 
+	for ( int y = 0 ; y < height ; y++ ) 
+	{
+		const unsigned char * in = mask + y * width ; 
+		int * out = &borders[ ( y + 1 ) * stride + 1 ] ; 
+		for ( int x = 0 ; x < width ; x++ ) 
+			out[x] = ( in[x] != 0 ) ? 1 : 0 ; 
+	}
+
+	int offsets[8] ; 
+	for ( int d = 0 ; d < 8 ; d++ ) 
+		offsets[d] = neighbourX[d] + neighbourY[d] * stride ; 
+
+	int * pixels = &borders[0] ; 
+	for ( int y = 1 ; y <= height ; y++ ) 
+	{
+		int lastBorder = 1 ; 
+		for ( int x = 1 ; x <= width ; x++ ) 
+		{
+			int p = y * stride + x ; 
+			int value = pixels[p] ; 
+			if ( value == 0 ) 
+				continue ; 
+
+			bool bOuter = ( value == 1 && pixels[ p - 1 ] == 0 ) ; 
+			bool bHole = ( bOuter == false && value >= 1 && pixels[ p + 1 ] == 0 ) ; 
+			if ( bOuter || bHole ) 
+			{
+				int border = borderIsHole.size() ; 
+				if ( bHole && value > 1 ) 
+					lastBorder = value ; 
+
+				//A border of the same kind as the last one we crossed is its sibling , otherwise its child
+				int parentBorder = ( ( borderIsHole[ lastBorder ] != 0 ) == bHole ) ? borderParent[ lastBorder ] : lastBorder ; 
+				borderIsHole.push_back( bHole ? 1 : 0 ) ; 
+				borderParent.push_back( parentBorder ) ; 
+				borderContour.push_back( -1 ) ; 
+
+				//Follow the border , starting from the 0 pixel that told us it's there
+				int first = points.size() ; 
+				int direction = bOuter ? 4 : 0 ; 
+				int found = -1 ; 
+				for ( int k = 0 ; k < 8 ; k++ ) 
+				{
+					int d = ( direction + k ) & 7 ; 
+					if ( pixels[ p + offsets[d] ] != 0 ) 
+					{
+						found = d ; 
+						break ; 
+					}
+				}
+
+				if ( found < 0 ) 
+				{
+					//Lone pixel
+					pixels[p] = -border ; 
+					points.push_back( ofPoint( x - 1 , y - 1 ) ) ; 
+				}
+				else
+				{
+					int firstNeighbour = p + offsets[ found ] ; 
+					int current = p ; 
+					int from = found ;				//where we came from , seen from current
+					for ( ; ; ) 
+					{
+						//Counter clockwise from the pixel after the one we came from
+						bool bEastIsZero = false ; 
+						int next = from ; 
+						for ( int k = 1 ; k <= 8 ; k++ ) 
+						{
+							int d = ( from - k ) & 7 ; 
+							if ( pixels[ current + offsets[d] ] != 0 ) 
+							{
+								next = d ; 
+								break ; 
+							}
+							if ( d == 0 ) 
+								bEastIsZero = true ; 
+						}
+
+						if ( bEastIsZero ) 
+							pixels[ current ] = -border ; 
+						else if ( pixels[ current ] == 1 ) 
+							pixels[ current ] = border ; 
+						points.push_back( ofPoint( current % stride - 1 , current / stride - 1 ) ) ; 
+
+						int nextPixel = current + offsets[ next ] ; 
+						if ( nextPixel == p && current == firstNeighbour ) 
+							break ; 
+						from = ( next + 4 ) & 7 ; 
+						current = nextPixel ; 
+					}
+				}
+
+				if ( (int) points.size() - first >= minPoints ) 
+				{
+					//Skipped parents don't count , hang it on the closest one we kept
+					while ( parentBorder > 1 && borderContour[ parentBorder ] < 0 ) 
+						parentBorder = borderParent[ parentBorder ] ; 
+					borderContour[ border ] = contours.size() ; 
+
+					IisuContour contour ; 
+					contour.start = first ; 
+					contour.count = points.size() - first ; 
+					contour.bHole = bHole ; 
+					contour.parent = ( parentBorder > 1 ) ? borderContour[ parentBorder ] : -1 ; 
+					contours.push_back( contour ) ; 
+				}
+				else
+				{
+					points.resize( first ) ; 
+				}
+			}
+
+			if ( pixels[p] != 1 ) 
+				lastBorder = abs( pixels[p] ) ; 
+		}
+	}
+}
+
+void IisuContourTracer::simplify( float tolerance ) 
+{
+	simplifiedContours.clear() ; 
+	simplifiedPoints.clear() ; 
+
+	float toleranceSquared = tolerance * tolerance ; 
+	for ( int i = 0 ; i < contours.size() ; i++ ) 
+		simplifyContour( contours[i] , toleranceSquared ) ; 
+}
+
+//Squared distance from p to the segment a - b
+static inline float segmentDistanceSquared( const ofPoint &p , const ofPoint &a , const ofPoint &b ) 
+{
+	float dx = b.x - a.x ; 
+	float dy = b.y - a.y ; 
+	float lengthSquared = dx * dx + dy * dy ; 
+	float t = 0.0f ; 
+	if ( lengthSquared > 0.0f ) 
+		t = ofClamp( ( ( p.x - a.x ) * dx + ( p.y - a.y ) * dy ) / lengthSquared , 0.0f , 1.0f ) ; 
+	float ex = a.x + t * dx - p.x ; 
+	float ey = a.y + t * dy - p.y ; 
+	return ex * ex + ey * ey ; 
+}
+
+void IisuContourTracer::simplifyContour( const IisuContour &contour , float toleranceSquared ) 
+{
+	IisuContour simplified = contour ; 
+	simplified.start = simplifiedPoints.size() ; 
+
+	int count = contour.count ; 
+	const ofPoint * in = &points[ contour.start ] ; 
+	if ( count < 4 ) 
+	{
+		simplifiedPoints.insert( simplifiedPoints.end() , in , in + count ) ; 
+		simplifiedContours.push_back( simplified ) ; 
+		return ; 
+	}
+
+	//Closed , so split it at the first point and the point farthest from it. Index count is the first point again
+	int farthest = 1 ; 
+	float farthestDistance = 0.0f ; 
+	for ( int i = 1 ; i < count ; i++ ) 
+	{
+		float distance = in[i].squareDistance( in[0] ) ; 
+		if ( distance > farthestDistance ) 
+		{
+			farthestDistance = distance ; 
+			farthest = i ; 
+		}
+	}
+
+	keep.assign( count , 0 ) ; 
+	keep[0] = 1 ; 
+	keep[ farthest ] = 1 ; 
+
+	stack.clear() ; 
+	stack.push_back( 0 ) ; stack.push_back( farthest ) ; 
+	stack.push_back( farthest ) ; stack.push_back( count ) ; 
+	while ( stack.empty() == false ) 
+	{
+		int last = stack.back() ; stack.pop_back() ; 
+		int first = stack.back() ; stack.pop_back() ; 
+		if ( last - first < 2 ) 
+			continue ; 
+
+		const ofPoint &a = in[ first ] ; 
+		const ofPoint &b = in[ last % count ] ; 
+		int split = -1 ; 
+		float splitDistance = toleranceSquared ; 
+		for ( int i = first + 1 ; i < last ; i++ ) 
+		{
+			float distance = segmentDistanceSquared( in[i] , a , b ) ; 
+			if ( distance > splitDistance ) 
+			{
+				splitDistance = distance ; 
+				split = i ; 
+			}
+		}
+
+		if ( split < 0 ) 
+			continue ; 
+		keep[ split ] = 1 ; 
+		stack.push_back( first ) ; stack.push_back( split ) ; 
+		stack.push_back( split ) ; stack.push_back( last ) ; 
+	}
+
+	for ( int i = 0 ; i < count ; i++ ) 
+	{
+		if ( keep[i] ) 
+			simplifiedPoints.push_back( in[i] ) ; 
+	}
+	simplified.count = simplifiedPoints.size() - simplified.start ; 
+	simplifiedContours.push_back( simplified ) ; 
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+/*
+	IisuContour
+	Outlines of a mask ( anything non zero , like IisuUserMask's output ) by Suzuki-Abe border following ,
+	outer borders and holes with their parent , then Douglas-Peucker simplification.
+	Every buffer is kept between calls so once it has seen a busy frame tracing doesn't allocate.
+*/
+
+#include "ofMain.h"
+
+struct IisuContour
+{
+	int start ;				//first point in the tracer's points ( or simplifiedPoints )
+	int count ; 
+	bool bHole ; 
+	int parent ;			//contour this one sits in , -1 for the outermost ones
+}; 
+
+class IisuContourTracer
+{
+	public :
+		IisuContourTracer( )
+		{
+			minPoints = 8 ; 
+		}
+
+		//Borders shorter than minPoints are skipped ( speckles )
+		void trace( const unsigned char * mask , int width , int height ) ; 
+
+		//tolerance in mask pixels. Fills simplifiedContours / simplifiedPoints , contours and points stay as traced
+		void simplify( float tolerance ) ; 
+
+		int minPoints ; 
+
+		//Border pixels in mask coordinates , contours index into the flat points array
+		vector<IisuContour> contours ; 
+		vector<ofPoint> points ; 
+
+		vector<IisuContour> simplifiedContours ; 
+		vector<ofPoint> simplifiedPoints ; 
+
+	protected :
+		void simplifyContour( const IisuContour &contour , float toleranceSquared ) ; 
+
+		int width , height , stride ; 
+		vector<int> borders ;				//padded by one pixel , 1 inside , border numbers once traced
+
+		//Per border number : hole or not , its contour or -1 if it was skipped , and its parent border
+		vector<unsigned char> borderIsHole ; 
+		vector<int> borderContour ; 
+		vector<int> borderParent ; 
+
+		vector<unsigned char> keep ; 
+		vector<int> stack ; 
+}; 
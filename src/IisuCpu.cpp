@@ -0,0 +1,80 @@
+#include "IisuCpu.h"
+
+#if defined( _MSC_VER ) && defined( IISU_X86 ) 
+#include <intrin.h>
+#endif
+
+#if defined( __GNUC__ ) && defined( IISU_X86 ) 
+#include <cpuid.h>
+#endif
+
+static void cpuid( int leaf , int subleaf , unsigned int registers[4] ) 
+{
+	registers[0] = registers[1] = registers[2] = registers[3] = 0 ; 
+#if defined( _MSC_VER ) && defined( IISU_X86 ) 
+	int info[4] ; 
+	__cpuidex( info , leaf , subleaf ) ; 
+	for ( int i = 0 ; i < 4 ; i++ ) 
+		registers[i] = (unsigned int) info[i] ; 
+#elif defined( __GNUC__ ) && defined( IISU_X86 ) 
+	__cpuid_count( leaf , subleaf , registers[0] , registers[1] , registers[2] , registers[3] ) ; 
+#endif
+}
+
+//The OS has to save the YMM registers too or AVX code will crash on a context switch
+static bool osSavesYmm( ) 
+{
+#if defined( _MSC_VER ) && defined( IISU_X86 ) && _MSC_VER >= 1600
+	return ( _xgetbv( 0 ) & 6 ) == 6 ; 
+#elif defined( __GNUC__ ) && defined( IISU_X86 ) 
+	unsigned int eax , edx ; 
+	__asm__ __volatile__ ( "xgetbv" : "=a"( eax ) , "=d"( edx ) : "c"( 0 ) ) ; 
+	return ( eax & 6 ) == 6 ; 
+#else
+	return false ; 
+#endif
+}
+
+static IisuSimdLevel detectSimdLevel( ) 
+{
+#ifdef IISU_X86
+	unsigned int registers[4] ; 
+	cpuid( 0 , 0 , registers ) ; 
+	unsigned int maxLeaf = registers[0] ; 
+
+	cpuid( 1 , 0 , registers ) ; 
+	bool bSSE2 = ( registers[3] & ( 1 << 26 ) ) != 0 ; 
+	bool bOSXSAVE = ( registers[2] & ( 1 << 27 ) ) != 0 ; 
+	bool bAVX = ( registers[2] & ( 1 << 28 ) ) != 0 ; 
+	if ( bSSE2 == false ) 
+		return IISU_SIMD_SCALAR ; 
+
+#ifdef IISU_HAS_AVX2_KERNELS
+	if ( maxLeaf >= 7 && bOSXSAVE && bAVX && osSavesYmm() ) 
+	{
+		cpuid( 7 , 0 , registers ) ; 
+		if ( registers[1] & ( 1 << 5 ) ) 
+			return IISU_SIMD_AVX2 ; 
+	}
+#endif
+	return IISU_SIMD_SSE2 ; 
+#else
+	return IISU_SIMD_SCALAR ; 
+#endif
+}
+
+IisuSimdLevel IisuCpu::getSimdLevel( ) 
+{
+	static IisuSimdLevel level = detectSimdLevel( ) ; 
+	return level ; 
+}
+
+const char * IisuCpu::getSimdName( IisuSimdLevel level ) 
+{
+	switch ( level ) 
+	{
+		case IISU_SIMD_AVX2 : return "AVX2" ; 
+		case IISU_SIMD_SSE2 : return "SSE2" ; 
+		default : return "scalar" ; 
+	}
+}
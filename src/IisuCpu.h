@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+	IisuCpu
+	What the processor we're running on can do , checked once. The SIMD kernels are all compiled in
+	and pick their path at runtime from this so one build runs everywhere.
+*/
+
+#if defined( _M_IX86 ) || defined( _M_X64 ) || defined( __i386__ ) || defined( __x86_64__ )
+#define IISU_X86 1
+#endif
+
+//AVX2 intrinsics need VS2012 or GCC / clang ( per function target attribute )
+#if defined( IISU_X86 ) && ( defined( __GNUC__ ) || ( defined( _MSC_VER ) && _MSC_VER >= 1700 ) )
+#define IISU_HAS_AVX2_KERNELS 1
+#endif
+
+#if defined( __GNUC__ ) 
+#define IISU_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#else
+#define IISU_TARGET_AVX2
+#endif
+
+enum IisuSimdLevel
+{
+	IISU_SIMD_SCALAR = 0 ,
+	IISU_SIMD_SSE2 = 1 ,
+	IISU_SIMD_AVX2 = 2
+};
+
+class IisuCpu
+{
+	public :
+		static IisuSimdLevel getSimdLevel( ) ;		//best level both the CPU and this build support
+		static const char * getSimdName( IisuSimdLevel level ) ; 
+
+		static bool hasSSE2( ) { return getSimdLevel( ) >= IISU_SIMD_SSE2 ; } 
+		static bool hasAVX2( ) { return getSimdLevel( ) >= IISU_SIMD_AVX2 ; } 
+};
@@ -14,10 +14,11 @@ class IisuEventArgs : public ofEventArgs
 {
     public:
     
-        IisuEventArgs( int _inputHex , float _holdDelay ) 
+        IisuEventArgs( int _inputHex , float _holdDelay , int _cursorID = -1 ) 
 		{
 			inputHex = _inputHex;
 			holdDelay = _holdDelay ; 
+			cursorID = _cursorID ; 
 		}
 
         virtual ~IisuEventArgs( ) { }
@@ -25,5 +26,45 @@ class IisuEventArgs : public ofEventArgs
         //Add whatever you need !
         int inputHex ; 
 		float holdDelay ; 
+		int cursorID ;			//the cursor that hovers , -1 if it isn't about one
     
 };
+
+//What sits in IisuEvents' deferred queue , see IisuEvents::post()
+enum IisuEventType
+{
+	IISU_EVENT_USER_DETECTED = 0 ,
+	IISU_EVENT_USER_LOST ,
+	IISU_EVENT_USER_ACTIVATED ,
+	IISU_EVENT_USER_DEACTIVATED ,
+	IISU_EVENT_POSE_GESTURE ,
+	IISU_EVENT_HAND_ACTIVATED ,
+	IISU_EVENT_HAND_DEACTIVATED ,
+	IISU_EVENT_CURSOR_DETECTED ,
+	IISU_EVENT_CURSOR_LOST ,
+	IISU_EVENT_CURSOR_DESTROYED 
+};
+
+struct IisuEventRecord
+{
+	IisuEventRecord( ) 
+	{
+		type = IISU_EVENT_USER_DETECTED ; 
+		id = -1 ; 
+		value = 0 ; 
+		frameID = -1 ; 
+	}
+
+	IisuEventRecord( IisuEventType _type , int _id , int _value , int _frameID ) 
+	{
+		type = _type ; 
+		id = _id ; 
+		value = _value ; 
+		frameID = _frameID ; 
+	}
+
+	IisuEventType type ; 
+	int id ;						//user slot , hand or cursor the event is about
+	int value ;						//event specific , the gesture type for POSE_GESTURE
+	int frameID ;					//latest iisu frame when it happened
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+	IisuEventQueue
+	Bounded multi producer / single consumer queue that never locks and never allocates once constructed.
+	Any thread can push() , one thread pop()s. Every slot carries a sequence number telling the producers
+	when it is free and the consumer when it is filled. When it's full push() fails and the record is dropped.
+	Capacity has to be a power of two.
+*/
+
+#include "IisuAtomic.h"
+
+template<typename T , int Capacity>
+class IisuEventQueue
+{
+	public :
+		IisuEventQueue( ) 
+		{
+			for ( int i = 0 ; i < Capacity ; i++ ) 
+				cells[i].sequence = i ; 
+			enqueuePosition = 0 ; 
+			dequeuePosition = 0 ; 
+			numDropped = 0 ; 
+		}
+
+		//Any thread
+		bool push( const T &value ) 
+		{
+			Cell * cell ; 
+			long position = iisuAtomicLoad( &enqueuePosition ) ; 
+			for ( ; ; ) 
+			{
+				cell = &cells[ position & MASK ] ; 
+				long difference = iisuAtomicLoad( &cell->sequence ) - position ; 
+				if ( difference == 0 ) 
+				{
+					//Slot is free , claim it before another producer does
+					if ( iisuAtomicCompareAndSwap( &enqueuePosition , position , position + 1 ) ) 
+						break ; 
+					position = iisuAtomicLoad( &enqueuePosition ) ; 
+				}
+				else if ( difference < 0 ) 
+				{
+					//The consumer hasn't freed this slot yet , we're a whole lap ahead
+					iisuAtomicAdd( &numDropped , 1 ) ; 
+					return false ; 
+				}
+				else
+				{
+					position = iisuAtomicLoad( &enqueuePosition ) ; 
+				}
+			}
+
+			cell->value = value ; 
+			iisuAtomicStore( &cell->sequence , position + 1 ) ; 
+			return true ; 
+		}
+
+		//Consumer thread only
+		bool pop( T &value ) 
+		{
+			Cell &cell = cells[ dequeuePosition & MASK ] ; 
+			if ( iisuAtomicLoad( &cell.sequence ) - ( dequeuePosition + 1 ) < 0 ) 
+				return false ; 
+
+			value = cell.value ; 
+			iisuAtomicStore( &cell.sequence , dequeuePosition + Capacity ) ; 
+			dequeuePosition++ ; 
+			return true ; 
+		}
+
+		int getNumDropped( ) { return iisuAtomicLoad( &numDropped ) ; } 
+
+	protected :
+		enum { MASK = Capacity - 1 } ; 
+
+		struct Cell
+		{
+			iisu_atomic_t sequence ; 
+			T value ; 
+		};
+
+		Cell cells[ Capacity ] ; 
+		iisu_atomic_t enqueuePosition ; 
+		long dequeuePosition ;				//only touched by the consumer
+		iisu_atomic_t numDropped ; 
+};
@@ -3,6 +3,20 @@
 
 #include "ofMain.h" 
 #include "IisuEventArgs.h"
+#include "IisuEventQueue.h"
+
+#define IISU_EVENT_QUEUE_SIZE 256
+
+//Gets the CURSOR_ events of one cursor ID only , see IisuEvents::addCursorListener()
+class IisuCursorListener
+{
+	public :
+		virtual ~IisuCursorListener( ) { } 
+
+		virtual void cursorFoundHandler( int cursorID ) { } 
+		virtual void cursorLostHandler( int cursorID ) { } 
+		virtual void cursorDestroyedHandler( int cursorID ) { } 
+};
 
 class IisuEvents
 {
@@ -17,22 +31,126 @@ class IisuEvents
         }
 
 		ofEvent<int> exitApplication ; 
-		ofEvent<IisuEventArgs> CURSOR_HOVER_START ; 
-		ofEvent<int> CURSOR_HOVER_FINISHED ; 
-		ofEvent<int> CURSOR_HOVER_INTERRUPTED ; 
+		ofEvent<IisuEventArgs> CURSOR_HOVER_START ;			//args : inputHex is the target , cursorID the cursor on it
+		ofEvent<IisuEventArgs> CURSOR_HOVER_FINISHED ; 
+		ofEvent<IisuEventArgs> CURSOR_HOVER_INTERRUPTED ; 
 
 		ofEvent<int> USER_DETECTED ;
 		ofEvent<int> USER_LOST ; 
+		ofEvent<int> USER_ACTIVATED ;			//args : user slot , 0 based
+		ofEvent<int> USER_DEACTIVATED ; 
 
 		ofEvent<int> HAND_CLOSE ; 
 		ofEvent<int> HAND_OPEN ; 
 		ofEvent<int> POSE_GESTURE ; 
 		ofEvent<int> HAND_CALIBRATED ; 
+		ofEvent<int> HAND_ACTIVATED ;			//args : hand ID
+		ofEvent<int> HAND_DEACTIVATED ; 
 
 		ofEvent<int> IDLE_INSTRUCTIONS ; 
-		ofEvent<int> CURSOR_DETECTED ; 
+		ofEvent<int> CURSOR_DETECTED ;			//args : cursor ID , every cursor's . Cursors themselves use addCursorListener()
 		ofEvent<int> CURSOR_LOST ; 
 		ofEvent<int> CURSOR_DESTROYED ; 
+
+		ofEvent<int> DEVICE_STALLED ;			//args : milliseconds since the last frame
+		ofEvent<int> DEVICE_RESUMED ;			//args : milliseconds the stall lasted
+		ofEvent<int> FRAMES_DROPPED ;			//args : camera frames lost since the last report
+
+		//Every deferred record again with its full payload , after the typed event above went out
+		ofEvent<IisuEventRecord> DEFERRED_EVENT ; 
+
+		//Queues an event from any thread , nothing runs until the app thread calls dispatchDeferred().
+		//Never blocks or allocates , if the app thread stopped draining the record is dropped
+		bool post( IisuEventType type , int id , int value = 0 , int frameID = -1 ) 
+		{
+			return deferred.push( IisuEventRecord( type , id , value , frameID ) ) ; 
+		}
+
+		//App thread , once per frame ( IisuServer::update() does it ). Delivers what was queued so far in one go
+		void dispatchDeferred( ) 
+		{
+			IisuEventRecord record ; 
+			//Bounded so listeners posting from inside a listener can't keep us here
+			for ( int i = 0 ; i < IISU_EVENT_QUEUE_SIZE && deferred.pop( record ) ; i++ ) 
+			{
+				int args = record.id ; 
+				switch ( record.type ) 
+				{
+					//These always sent 9 , listeners written against that keep getting it. DEFERRED_EVENT has the user
+					case IISU_EVENT_USER_DETECTED : args = 9 ; ofNotifyEvent( USER_DETECTED , args ) ; break ; 
+					case IISU_EVENT_USER_LOST : args = 9 ; ofNotifyEvent( USER_LOST , args ) ; break ; 
+					case IISU_EVENT_USER_ACTIVATED : ofNotifyEvent( USER_ACTIVATED , args ) ; break ; 
+					case IISU_EVENT_USER_DEACTIVATED : ofNotifyEvent( USER_DEACTIVATED , args ) ; break ; 
+					case IISU_EVENT_POSE_GESTURE : 
+						args = record.value ; 
+						ofNotifyEvent( POSE_GESTURE , args ) ; 
+						break ; 
+					case IISU_EVENT_HAND_ACTIVATED : ofNotifyEvent( HAND_ACTIVATED , args ) ; break ; 
+					case IISU_EVENT_HAND_DEACTIVATED : ofNotifyEvent( HAND_DEACTIVATED , args ) ; break ; 
+					case IISU_EVENT_CURSOR_DETECTED : 
+					case IISU_EVENT_CURSOR_LOST : 
+					case IISU_EVENT_CURSOR_DESTROYED : 
+						dispatchCursor( record ) ; 
+						break ; 
+				}
+				ofNotifyEvent( DEFERRED_EVENT , record ) ; 
+			}
+		}
+
+		//App thread. One listener per cursor ID , the table is indexed straight by ID so routing is a lookup.
+		//IDs are UI.CONTROLLER indices , the only cursors iisu sends CURSOR_ events for. CI hands share the numbers
+		//but are a different thing , they don't belong in here
+		void addCursorListener( int cursorID , IisuCursorListener * listener ) 
+		{
+			if ( cursorID < 0 ) 
+				return ; 
+			if ( cursorID >= cursorListeners.size() ) 
+				cursorListeners.resize( cursorID + 1 , NULL ) ; 
+			cursorListeners[ cursorID ] = listener ; 
+		}
+
+		//Only clears the slot if listener still owns it
+		void removeCursorListener( int cursorID , IisuCursorListener * listener ) 
+		{
+			if ( cursorID >= 0 && cursorID < cursorListeners.size() && cursorListeners[ cursorID ] == listener ) 
+				cursorListeners[ cursorID ] = NULL ; 
+		}
+
+		IisuCursorListener * getCursorListener( int cursorID ) 
+		{
+			if ( cursorID >= 0 && cursorID < cursorListeners.size() ) 
+				return cursorListeners[ cursorID ] ; 
+			return NULL ; 
+		}
+
+		int getNumDroppedEvents( ) { return deferred.getNumDropped( ) ; } 
+
+	protected :
+		void dispatchCursor( const IisuEventRecord &record ) 
+		{
+			int cursorID = record.id ; 
+			IisuCursorListener * listener = getCursorListener( cursorID ) ; 
+			switch ( record.type ) 
+			{
+				case IISU_EVENT_CURSOR_DETECTED : 
+					if ( listener != NULL ) listener->cursorFoundHandler( cursorID ) ; 
+					ofNotifyEvent( CURSOR_DETECTED , cursorID ) ; 
+					break ; 
+				case IISU_EVENT_CURSOR_LOST : 
+					if ( listener != NULL ) listener->cursorLostHandler( cursorID ) ; 
+					ofNotifyEvent( CURSOR_LOST , cursorID ) ; 
+					break ; 
+				case IISU_EVENT_CURSOR_DESTROYED : 
+					if ( listener != NULL ) listener->cursorDestroyedHandler( cursorID ) ; 
+					ofNotifyEvent( CURSOR_DESTROYED , cursorID ) ; 
+					break ; 
+				default : 
+					break ; 
+			}
+		}
+
+		IisuEventQueue<IisuEventRecord , IISU_EVENT_QUEUE_SIZE> deferred ; 
+		vector<IisuCursorListener*> cursorListeners ;		//indexed by cursor ID
 		
 };
 
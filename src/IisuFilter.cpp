@@ -0,0 +1,217 @@
+#include "IisuFilter.h"
+
+#ifdef IISU_X86
+#include <xmmintrin.h>
+#endif
+
+void IisuFilterBank::setup( int numChannels , const IisuFilterSettings &_settings )
+{
+	settings = _settings ; 
+	lastTime.assign( numChannels , -1.0 ) ; 
+	value.assign( numChannels , 0.0f ) ; 
+	velocity.assign( numChannels , 0.0f ) ; 
+	p00.assign( numChannels , 0.0f ) ; 
+	p01.assign( numChannels , 0.0f ) ; 
+	p11.assign( numChannels , 0.0f ) ; 
+}
+
+void IisuFilterBank::reset( int firstChannel , int count )
+{
+	int last = MIN( firstChannel + count , getNumChannels() ) ; 
+	for ( int i = MAX( firstChannel , 0 ) ; i < last ; i++ )
+		lastTime[i] = -1.0 ; 
+}
+
+void IisuFilterBank::filter( float * values , int firstChannel , int count , double time )
+{
+	if ( firstChannel < 0 || firstChannel + count > getNumChannels() || count <= 0 || settings.type == IISU_FILTER_NONE )
+		return ; 
+
+	//Channels that are new or were gone too long start over from this sample , that leaves them with dt 0 below
+	double * times = &lastTime[ firstChannel ] ; 
+	for ( int i = 0 ; i < count ; i++ )
+	{
+		if ( times[i] < 0.0 || time - times[i] > settings.resetSeconds )
+			startChannel( firstChannel + i , values[i] , time ) ; 
+	}
+
+	//Runs of channels sampled at the same time share one dt , most calls are a single run
+	IisuSimdLevel level = IisuCpu::getSimdLevel() ; 
+	float * state = &value[ firstChannel ] ; 
+	int first = 0 ; 
+	while ( first < count )
+	{
+		int last = first + 1 ; 
+		while ( last < count && times[ last ] == times[ first ] )
+			last++ ; 
+
+		float dt = (float) ( time - times[ first ] ) ; 
+		if ( dt > 0.0f )
+		{
+			switch ( settings.type )
+			{
+				case IISU_FILTER_ONE_EURO : filterOneEuro( values + first , firstChannel + first , last - first , dt , level ) ; break ; 
+				case IISU_FILTER_KALMAN : filterKalman( values + first , firstChannel + first , last - first , dt , level ) ; break ; 
+				default : break ; 
+			}
+			for ( int i = first ; i < last ; i++ )
+				times[i] = time ; 
+		}
+		else
+		{
+			//Same frame again or just restarted , nothing new to filter
+			for ( int i = first ; i < last ; i++ )
+				values[i] = state[i] ; 
+		}
+		first = last ; 
+	}
+}
+
+void IisuFilterBank::startChannel( int channel , float sample , double time )
+{
+	float r = MAX( settings.measurementNoise , 0.000001f ) ; 
+	value[ channel ] = sample ; 
+	velocity[ channel ] = 0.0f ; 
+	p00[ channel ] = r ; 
+	p01[ channel ] = 0.0f ; 
+	p11[ channel ] = r ; 
+	lastTime[ channel ] = time ; 
+}
+
+//Smoothing factor of a first order low pass with the given cutoff , sampled dt seconds apart.
+//1 / ( 1 + tau / dt ) with tau = 1 / ( 2 pi cutoff ) , written so the SSE path can do the same thing
+static inline float lowPassAlpha( float cutoff , float dt )
+{
+	float k = TWO_PI * cutoff * dt ; 
+	return k / ( k + 1.0f ) ; 
+}
+
+void IisuFilterBank::filterOneEuro( float * values , int firstChannel , int count , float dt , IisuSimdLevel level )
+{
+	float * state = &value[ firstChannel ] ; 
+	float * derivative = &velocity[ firstChannel ] ; 
+	float minCutoff = settings.minCutoff ; 
+	float beta = settings.beta ; 
+	float derivativeAlpha = lowPassAlpha( MAX( settings.derivativeCutoff , 0.0001f ) , dt ) ; 
+	float invDt = 1.0f / dt ; 
+	float cutoffScale = TWO_PI * dt ; 
+	int i = 0 ; 
+
+#ifdef IISU_X86
+	if ( level >= IISU_SIMD_SSE2 )
+	{
+		__m128 alphaD = _mm_set1_ps( derivativeAlpha ) ; 
+		__m128 inv = _mm_set1_ps( invDt ) ; 
+		__m128 minC = _mm_set1_ps( minCutoff ) ; 
+		__m128 b = _mm_set1_ps( beta ) ; 
+		__m128 floorC = _mm_set1_ps( 0.0001f ) ; 
+		__m128 scale = _mm_set1_ps( cutoffScale ) ; 
+		__m128 one = _mm_set1_ps( 1.0f ) ; 
+		__m128 sign = _mm_set1_ps( -0.0f ) ; 
+		for ( ; i + 4 <= count ; i += 4 )
+		{
+			__m128 v = _mm_loadu_ps( values + i ) ; 
+			__m128 s = _mm_loadu_ps( state + i ) ; 
+			__m128 d = _mm_loadu_ps( derivative + i ) ; 
+
+			__m128 delta = _mm_sub_ps( v , s ) ; 
+			d = _mm_add_ps( d , _mm_mul_ps( alphaD , _mm_sub_ps( _mm_mul_ps( delta , inv ) , d ) ) ) ; 
+			__m128 cutoff = _mm_max_ps( _mm_add_ps( minC , _mm_mul_ps( b , _mm_andnot_ps( sign , d ) ) ) , floorC ) ; 
+			__m128 k = _mm_mul_ps( scale , cutoff ) ; 
+			s = _mm_add_ps( s , _mm_mul_ps( _mm_div_ps( k , _mm_add_ps( k , one ) ) , delta ) ) ; 
+
+			_mm_storeu_ps( derivative + i , d ) ; 
+			_mm_storeu_ps( state + i , s ) ; 
+			_mm_storeu_ps( values + i , s ) ; 
+		}
+	}
+#endif
+
+	for ( ; i < count ; i++ )
+	{
+		float delta = values[i] - state[i] ; 
+		derivative[i] += derivativeAlpha * ( delta * invDt - derivative[i] ) ; 
+		float cutoff = MAX( minCutoff + beta * fabsf( derivative[i] ) , 0.0001f ) ; 
+		float k = cutoffScale * cutoff ; 
+		state[i] += k / ( k + 1.0f ) * delta ; 
+		values[i] = state[i] ; 
+	}
+}
+
+void IisuFilterBank::filterKalman( float * values , int firstChannel , int count , float dt , IisuSimdLevel level )
+{
+	float * position = &value[ firstChannel ] ; 
+	float * speed = &velocity[ firstChannel ] ; 
+	float * c00 = &p00[ firstChannel ] ; 
+	float * c01 = &p01[ firstChannel ] ; 
+	float * c11 = &p11[ firstChannel ] ; 
+	float q = settings.processNoise ; 
+	float r = MAX( settings.measurementNoise , 0.000001f ) ; 
+
+	//Predict , x += v dt with white noise acceleration. The noise terms only depend on dt
+	float dt2 = dt * dt ; 
+	float q00 = q * dt2 * dt / 3.0f ; 
+	float q01 = q * dt2 * 0.5f ; 
+	float q11 = q * dt ; 
+	int i = 0 ; 
+
+#ifdef IISU_X86
+	if ( level >= IISU_SIMD_SSE2 )
+	{
+		__m128 t = _mm_set1_ps( dt ) ; 
+		__m128 two = _mm_set1_ps( 2.0f ) ; 
+		__m128 one = _mm_set1_ps( 1.0f ) ; 
+		__m128 n00 = _mm_set1_ps( q00 ) , n01 = _mm_set1_ps( q01 ) , n11 = _mm_set1_ps( q11 ) ; 
+		__m128 noise = _mm_set1_ps( r ) ; 
+		for ( ; i + 4 <= count ; i += 4 )
+		{
+			__m128 x = _mm_loadu_ps( position + i ) ; 
+			__m128 v = _mm_loadu_ps( speed + i ) ; 
+			__m128 b00 = _mm_loadu_ps( c00 + i ) ; 
+			__m128 b01 = _mm_loadu_ps( c01 + i ) ; 
+			__m128 b11 = _mm_loadu_ps( c11 + i ) ; 
+
+			x = _mm_add_ps( x , _mm_mul_ps( v , t ) ) ; 
+			__m128 a00 = _mm_add_ps( _mm_add_ps( b00 , _mm_mul_ps( t , _mm_add_ps( _mm_mul_ps( two , b01 ) , _mm_mul_ps( t , b11 ) ) ) ) , n00 ) ; 
+			__m128 a01 = _mm_add_ps( _mm_add_ps( b01 , _mm_mul_ps( t , b11 ) ) , n01 ) ; 
+			__m128 a11 = _mm_add_ps( b11 , n11 ) ; 
+
+			__m128 s = _mm_add_ps( a00 , noise ) ; 
+			__m128 k0 = _mm_div_ps( a00 , s ) ; 
+			__m128 k1 = _mm_div_ps( a01 , s ) ; 
+			__m128 innovation = _mm_sub_ps( _mm_loadu_ps( values + i ) , x ) ; 
+			x = _mm_add_ps( x , _mm_mul_ps( k0 , innovation ) ) ; 
+			v = _mm_add_ps( v , _mm_mul_ps( k1 , innovation ) ) ; 
+			__m128 keep = _mm_sub_ps( one , k0 ) ; 
+
+			_mm_storeu_ps( position + i , x ) ; 
+			_mm_storeu_ps( speed + i , v ) ; 
+			_mm_storeu_ps( c00 + i , _mm_mul_ps( keep , a00 ) ) ; 
+			_mm_storeu_ps( c01 + i , _mm_mul_ps( keep , a01 ) ) ; 
+			_mm_storeu_ps( c11 + i , _mm_sub_ps( a11 , _mm_mul_ps( k1 , a01 ) ) ) ; 
+			_mm_storeu_ps( values + i , x ) ; 
+		}
+	}
+#endif
+
+	for ( ; i < count ; i++ )
+	{
+		position[i] += speed[i] * dt ; 
+		float a00 = c00[i] + dt * ( 2.0f * c01[i] + dt * c11[i] ) + q00 ; 
+		float a01 = c01[i] + dt * c11[i] + q01 ; 
+		float a11 = c11[i] + q11 ; 
+
+		//Correct with the measured position
+		float s = a00 + r ; 
+		float k0 = a00 / s ; 
+		float k1 = a01 / s ; 
+		float innovation = values[i] - position[i] ; 
+		position[i] += k0 * innovation ; 
+		speed[i] += k1 * innovation ; 
+		c00[i] = ( 1.0f - k0 ) * a00 ; 
+		c01[i] = ( 1.0f - k0 ) * a01 ; 
+		c11[i] = a11 - k1 * a01 ; 
+
+		values[i] = position[i] ; 
+	}
+}
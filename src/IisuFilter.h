@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+	IisuFilterBank
+	Smooths a block of float channels ( joint coordinates , cursor positions , finger tips ... ) in one pass per call.
+	State is kept as structure of arrays so every channel runs the same straight loop. Each channel remembers the
+	time of its last sample : filtering the same frame twice changes nothing and a channel that was gone for
+	longer than resetSeconds starts over , so the result only depends on frame timestamps , not on how often you call it.
+	Restarts are sorted out in a pass of their own first , then channels last sampled together ( usually the whole
+	call ) share one dt and go through the filter four at a time when IisuCpu has SSE2.
+*/
+
+#include "ofMain.h"
+#include "IisuCpu.h"
+
+enum IisuFilterType
+{
+	IISU_FILTER_NONE = 0 ,
+	IISU_FILTER_ONE_EURO ,			//Casiez et al. , adaptive low pass : smooth when slow , responsive when fast
+	IISU_FILTER_KALMAN				//constant velocity Kalman , one per channel
+}; 
+
+struct IisuFilterSettings
+{
+	IisuFilterSettings( IisuFilterType _type = IISU_FILTER_ONE_EURO )
+	{
+		type = _type ; 
+		minCutoff = 1.0f ; 
+		beta = 0.007f ; 
+		derivativeCutoff = 1.0f ; 
+		processNoise = 500.0f ; 
+		measurementNoise = 4.0f ; 
+		resetSeconds = 0.5f ; 
+	}
+
+	IisuFilterType type ; 
+
+	//One Euro , cutoffs in Hz. beta is in 1 / channel units so it depends on what's filtered ( pixels , meters )
+	float minCutoff ; 
+	float beta ; 
+	float derivativeCutoff ; 
+
+	//Kalman , acceleration noise ( units / s^2 )^2 and measurement noise units^2
+	float processNoise ; 
+	float measurementNoise ; 
+
+	float resetSeconds ; 
+}; 
+
+class IisuFilterBank
+{
+	public :
+		IisuFilterBank( ) { }
+
+		//Channels start out empty , their first sample passes straight through
+		void setup( int numChannels , const IisuFilterSettings &_settings ) ; 
+		void setup( int numChannels ) { setup( numChannels , settings ) ; }
+		int getNumChannels( ) { return lastTime.size() ; }
+
+		//Filters values[0 .. count) in place as channels firstChannel .. firstChannel + count , all sampled at time ( seconds )
+		void filter( float * values , int firstChannel , int count , double time ) ; 
+
+		//Forget channels , like when a user or cursor goes away
+		void reset( int firstChannel , int count ) ; 
+		void reset( ) { reset( 0 , getNumChannels() ) ; }
+
+		//Can be changed any time , channels keep their state
+		IisuFilterSettings settings ; 
+
+	protected :
+		//New first sample for channel , what a restart leaves behind
+		void startChannel( int channel , float sample , double time ) ; 
+
+		//values[0 .. count) as channels firstChannel .. , every one of them last sampled dt seconds ago
+		void filterOneEuro( float * values , int firstChannel , int count , float dt , IisuSimdLevel level ) ; 
+		void filterKalman( float * values , int firstChannel , int count , float dt , IisuSimdLevel level ) ; 
+
+		vector<double> lastTime ;			//< 0 until the first sample
+		vector<float> value ;				//last filtered value
+		vector<float> velocity ;			//One Euro : filtered derivative , Kalman : velocity estimate
+		vector<float> p00 , p01 , p11 ;		//Kalman covariance
+}; 
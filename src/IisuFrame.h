@@ -0,0 +1,194 @@
+#pragma once
+
+/*
+	IisuFrame
+	Plain copy of everything IisuServer reads from iisu for a single DEVICE.DataFrame.
+	The live device and the replay sources both fill one of these so the rest of the
+	pipeline ( skeleton, user representation, cursors ) doesn't care where the data came from.
+*/
+
+#include <SDK/iisuSDK.h>
+#include <vector>
+#include "IisuSchema.h"
+
+using namespace SK;
+using namespace std;
+
+//Key points per skeleton
+#define IISU_NUM_JOINTS SK::SkeletonEnum::_COUNT
+
+//Joint a key point hangs off , -1 for the pelvis. Parents always come before their children
+inline int iisuJointParent( int joint ) 
+{
+	static const int parents[ SK::SkeletonEnum::_COUNT ] = 
+	{
+		-1 , 0 , 1 , 2 , 3 ,			//pelvis , waist , collar , neck , head
+		2 , 5 , 6 , 7 ,					//right shoulder , elbow , wrist , hand
+		0 , 9 , 10 , 11 ,				//right hip , knee , ankle , foot
+		2 , 13 , 14 , 15 ,				//left shoulder , elbow , wrist , hand
+		0 , 17 , 18 , 19				//left hip , knee , ankle , foot
+	} ; 
+	return ( joint >= 0 && joint < SK::SkeletonEnum::_COUNT ) ? parents[ joint ] : -1 ; 
+}
+
+//UI.CONTROLLER# and CI.HAND# , one member per field of IisuSchema.h
+IISU_SCHEMA_VALUES( IisuControllerFrame , IISU_CONTROLLER_FIELDS )
+IISU_SCHEMA_VALUES( IisuHandFrame , IISU_HAND_FIELDS )
+
+struct IisuFrame
+{
+	IisuFrame( )
+	{
+		frameID = -1 ;
+		timestamp = 0.0 ;
+		userIsActive = false ;
+		user1SceneID = 0 ;
+		skeletonStatus = 0 ;
+		centroidCount = 0 ;
+		labelWidth = 0 ;
+		labelHeight = 0 ;
+		deliveredMicros = 0 ;
+	}
+
+	//Sizes the per user arrays , done once at setup so a frame never resizes them. Slots already there are kept
+	void setNumUserSlots( int numSlots ) 
+	{
+		activeUsers.reserve( numSlots ) ; 
+		userActive.resize( numSlots , 0 ) ; 
+		userSceneIDs.resize( numSlots , 0 ) ; 
+		userSkeletonStatus.resize( numSlots , 0 ) ; 
+		userMassCenters.resize( numSlots , Vector3( 0 , 0 , 0 ) ) ; 
+		userKeyPoints.resize( numSlots * IISU_NUM_JOINTS , Vector3( 0 , 0 , 0 ) ) ; 
+		userKeyPointsConfidence.resize( numSlots * IISU_NUM_JOINTS , 0.0f ) ; 
+	}
+
+	//Zeros only the slots that were filled , the others already are
+	void clearUsers( ) 
+	{
+		for ( int i = 0 ; i < activeUsers.size() ; i++ ) 
+		{
+			int user = activeUsers[i] ; 
+			userActive[ user ] = 0 ; 
+			userSceneIDs[ user ] = 0 ; 
+			userSkeletonStatus[ user ] = 0 ; 
+			userMassCenters[ user ] = Vector3( 0 , 0 , 0 ) ; 
+			for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+			{
+				userKeyPoints[ user * IISU_NUM_JOINTS + j ] = Vector3( 0 , 0 , 0 ) ; 
+				userKeyPointsConfidence[ user * IISU_NUM_JOINTS + j ] = 0.0f ; 
+			}
+		}
+		activeUsers.clear() ; 
+	}
+
+	int getNumUserSlots( ) const { return userActive.size() ; } 
+
+	//IISU_NUM_JOINTS key points of one user
+	const Vector3 * getUserKeyPoints( int user ) const { return &userKeyPoints[ user * IISU_NUM_JOINTS ] ; } 
+	const float * getUserKeyPointsConfidence( int user ) const { return &userKeyPointsConfidence[ user * IISU_NUM_JOINTS ] ; } 
+
+	//Grows every vector up front so capturing a frame of this size never has to allocate
+	void reserve( int numKeyPoints , int numCentroids , int numLabelPixels ) 
+	{
+		keyPoints.reserve( numKeyPoints ) ; 
+		keyPointsConfidence.reserve( numKeyPoints ) ; 
+		centroidPositions.reserve( numCentroids ) ; 
+		centroidJumpStatus.reserve( numCentroids ) ; 
+		labelImage.reserve( numLabelPixels ) ; 
+	}
+
+	int32_t							frameID ;
+	double							timestamp ;			//seconds, only the difference between two frames matters
+	unsigned long long				deliveredMicros ;	//IisuProfiler::now() when the frame arrived , not recorded
+
+	//USER
+	bool							userIsActive ;
+	int32_t							user1SceneID ;
+	Vector3							user1MassCenter ;
+
+	//Skeleton + Volume
+	int32_t							skeletonStatus ;
+	vector<Vector3>					keyPoints ;
+	vector<float>					keyPointsConfidence ;
+	int32_t							centroidCount ;
+	vector<Vector3>					centroidPositions ;
+	vector<int>						centroidJumpStatus ;
+
+	//Every USER# iisu tracks , USER1 is slot 0. Only the slots listed in activeUsers were read this frame ,
+	//the rest hold zeros. Joint data is laid out [ user * IISU_NUM_JOINTS + joint ]
+	vector<int>						activeUsers ; 
+	vector<unsigned char>			userActive ; 
+	vector<int32_t>					userSceneIDs ; 
+	vector<int32_t>					userSkeletonStatus ; 
+	vector<Vector3>					userMassCenters ; 
+	vector<Vector3>					userKeyPoints ; 
+	vector<float>					userKeyPointsConfidence ; 
+
+	//SCENE.LabelImage , one byte per pixel
+	int								labelWidth ;
+	int								labelHeight ;
+	vector<unsigned char>			labelImage ;
+
+	vector<IisuControllerFrame>		controllers ;
+	vector<IisuHandFrame>			hands ;
+};
+
+//Read only window onto an array someone else owns , usually the current frame ( IisuServer::getFrame() ).
+//Nothing is copied , it's good until that owner changes , for frame data until the next IisuServer::update()
+template<typename T>
+struct IisuArrayView
+{
+	IisuArrayView( ) { data = NULL ; count = 0 ; } 
+	IisuArrayView( const T * _data , int _count ) { data = _data ; count = _count ; } 
+	IisuArrayView( const vector<T> &source ) 
+	{
+		data = source.empty() ? NULL : &source[0] ; 
+		count = source.size() ; 
+	}
+
+	int size( ) const { return count ; } 
+	bool empty( ) const { return ( count == 0 ) ; } 
+	const T& operator[]( int index ) const { return data[ index ] ; } 
+	const T * begin( ) const { return data ; } 
+	const T * end( ) const { return data + count ; } 
+
+	const T * data ; 
+	int count ; 
+};
+
+//Copies an iisu array into one of the frame vectors , reusing whatever capacity the vector already has
+template<typename T>
+inline void copyIisuArray( vector<T> &destination , const SK::Array<T> &source ) 
+{
+	destination.assign( source.begin() , source.end() ) ; 
+}
+
+//A schema field into its frame value , see IISU_SCHEMA_HANDLES
+template<typename T>
+inline void fetchIisuValue( T &value , SK::DataHandle<T> &handle ) 
+{
+	value = handle.get() ; 
+}
+
+template<typename T>
+inline void fetchIisuValue( vector<T> &value , SK::DataHandle< SK::Array<T> > &handle ) 
+{
+	copyIisuArray( value , handle.get() ) ; 
+}
+
+//The other way around , within the capacity destination already has like SK::Array's own operator=
+template<typename T>
+inline void assignIisuArray( SK::Array<T> &destination , const vector<T> &source ) 
+{
+	destination.resize( source.size() , false ) ; 
+	for ( size_t i = 0 ; i < source.size() ; i++ ) 
+		destination[ i ] = source[ i ] ; 
+}
+
+template<typename T>
+inline void assignIisuArray( SK::Array<T> &destination , const IisuArrayView<T> &source ) 
+{
+	destination.resize( source.size() , false ) ; 
+	for ( int i = 0 ; i < source.size() ; i++ ) 
+		destination[ i ] = source[ i ] ; 
+}
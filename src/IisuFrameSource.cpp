@@ -0,0 +1,42 @@
+#include "IisuFrameSource.h"
+
+bool IisuMemoryFrameSource::open( ) 
+{
+	rewind( ) ; 
+	return ( frames.size() > 0 ) ; 
+}
+
+void IisuMemoryFrameSource::rewind( ) 
+{
+	playhead = 0 ; 
+	loopTimeOffset = 0.0 ; 
+}
+
+bool IisuMemoryFrameSource::readFrame( IisuFrame &frame ) 
+{
+	if ( frames.size() == 0 ) 
+		return false ; 
+
+	if ( playhead >= frames.size() ) 
+	{
+		if ( bLoop == false ) 
+			return false ; 
+
+		//Keep time moving forward when we wrap around so native rate pacing still works
+		double duration = frames.back().timestamp - frames.front().timestamp ; 
+		if ( frames.size() > 1 ) 
+			duration += duration / ( frames.size() - 1 ) ; 
+		loopTimeOffset += duration ; 
+		playhead = 0 ; 
+	}
+
+	frame = frames[ playhead ] ; 
+	frame.timestamp += loopTimeOffset ; 
+	playhead++ ; 
+	return true ; 
+}
+
+void IisuMemoryFrameSource::addFrame( const IisuFrame &frame ) 
+{
+	frames.push_back( frame ) ; 
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+/*
+	IisuFrameSource
+	Anything that can hand IisuServer a stream of IisuFrames without a camera attached.
+	IisuServer::setup( source , ... ) replays it instead of creating an iisu handle + device.
+*/
+
+#include "IisuFrame.h"
+
+class IisuFrameSource
+{
+	public :
+		IisuFrameSource( ) { } 
+		virtual ~IisuFrameSource( ) { } 
+
+		virtual bool open( ) = 0 ; 
+		virtual void close( ) { } 
+
+		//Copy the next frame into frame, returns false once the stream has run out
+		virtual bool readFrame( IisuFrame &frame ) = 0 ; 
+		virtual void rewind( ) = 0 ; 
+};
+
+//Replays frames held in memory, handy for synthetic load tests
+class IisuMemoryFrameSource : public IisuFrameSource
+{
+	public :
+		IisuMemoryFrameSource( ) 
+		{
+			playhead = 0 ; 
+			bLoop = false ; 
+			loopTimeOffset = 0.0 ; 
+		}
+
+		bool open( ) ; 
+		bool readFrame( IisuFrame &frame ) ; 
+		void rewind( ) ; 
+
+		void addFrame( const IisuFrame &frame ) ; 
+		int getNumFrames( ) { return frames.size() ; } 
+
+		bool bLoop ;			//start over at the end instead of running out
+
+	protected :
+		vector<IisuFrame> frames ; 
+		int playhead ; 
+		double loopTimeOffset ; 
+};
@@ -0,0 +1,119 @@
+#include "IisuFrameTracker.h"
+
+IisuFrameTracker::IisuFrameTracker( ) 
+{
+	stallMillis = 500 ; 
+	reportMillis = 1000 ; 
+	reset( ) ; 
+}
+
+void IisuFrameTracker::reset( ) 
+{
+	lastFrameID = -1 ; 
+	lastArrivalMicros = 0 ; 
+	lastIntervalMillis = 0.0f ; 
+	averageIntervalMillis = 0.0f ; 
+	iisuAtomicStore( &numFrames , 0 ) ; 
+	iisuAtomicStore( &numDuplicates , 0 ) ; 
+	iisuAtomicStore( &numGaps , 0 ) ; 
+	iisuAtomicStore( &numDroppedFrames , 0 ) ; 
+	iisuAtomicStore( &lastArrivalMillis , 0 ) ; 
+	for ( int i = 0 ; i < IISU_JITTER_BINS ; i++ ) 
+		iisuAtomicStore( &jitterHistogram[i] , 0 ) ; 
+
+	numLatchedFrames = 0 ; 
+	numStalls = 0 ; 
+	bStalled = false ; 
+	stallStartMicros = 0 ; 
+	numReportedDroppedFrames = 0 ; 
+	lastReportMicros = 0 ; 
+}
+
+void IisuFrameTracker::addFrame( int32_t frameID , unsigned long long micros ) 
+{
+	if ( lastFrameID >= 0 ) 
+	{
+		if ( frameID == lastFrameID ) 
+		{
+			iisuAtomicAdd( &numDuplicates , 1 ) ; 
+			return ; 
+		}
+
+		//A smaller ID means iisu restarted or a recording looped , start counting again from there
+		if ( frameID > lastFrameID + 1 ) 
+		{
+			iisuAtomicAdd( &numGaps , 1 ) ; 
+			iisuAtomicAdd( &numDroppedFrames , frameID - lastFrameID - 1 ) ; 
+		}
+
+		lastIntervalMillis = ( micros - lastArrivalMicros ) / 1000.0f ; 
+		if ( averageIntervalMillis == 0.0f ) 
+			averageIntervalMillis = lastIntervalMillis ; 
+		else
+			averageIntervalMillis += ( lastIntervalMillis - averageIntervalMillis ) * 0.05f ; 
+
+		int bin = MIN( (int) ( lastIntervalMillis / IISU_JITTER_BIN_MILLIS ) , IISU_JITTER_BINS - 1 ) ; 
+		iisuAtomicAdd( &jitterHistogram[ bin ] , 1 ) ; 
+	}
+
+	lastFrameID = frameID ; 
+	lastArrivalMicros = micros ; 
+	iisuAtomicStore( &lastArrivalMillis , (long) ( micros / 1000 ) ) ; 
+	iisuAtomicAdd( &numFrames , 1 ) ; 
+}
+
+void IisuFrameTracker::addLatchedFrame( ) 
+{
+	numLatchedFrames++ ; 
+}
+
+void IisuFrameTracker::checkHealth( unsigned long long micros ) 
+{
+	long arrivalMillis = iisuAtomicLoad( &lastArrivalMillis ) ; 
+	if ( arrivalMillis == 0 ) 
+		return ; 
+
+	//Only the low bits of the clock made it through the atomic , compare in that range
+	int sinceArrival = (int) ( (long) ( micros / 1000 ) - arrivalMillis ) ; 
+	if ( bStalled == false && sinceArrival > stallMillis ) 
+	{
+		bStalled = true ; 
+		numStalls++ ; 
+		stallStartMicros = micros - sinceArrival * 1000ULL ; 
+		ofNotifyEvent( IisuEvents::Instance()->DEVICE_STALLED , sinceArrival ) ; 
+	}
+	else if ( bStalled && sinceArrival <= stallMillis ) 
+	{
+		bStalled = false ; 
+		int stallLength = (int) ( ( micros - stallStartMicros ) / 1000 ) - sinceArrival ; 
+		ofNotifyEvent( IisuEvents::Instance()->DEVICE_RESUMED , stallLength ) ; 
+	}
+
+	if ( micros - lastReportMicros < reportMillis * 1000ULL ) 
+		return ; 
+
+	lastReportMicros = micros ; 
+	int dropped = iisuAtomicLoad( &numDroppedFrames ) ; 
+	int newlyDropped = dropped - numReportedDroppedFrames ; 
+	numReportedDroppedFrames = dropped ; 
+	if ( newlyDropped > 0 ) 
+		ofNotifyEvent( IisuEvents::Instance()->FRAMES_DROPPED , newlyDropped ) ; 
+}
+
+IisuFrameStats IisuFrameTracker::getStats( ) 
+{
+	IisuFrameStats stats ; 
+	stats.numFrames = iisuAtomicLoad( &numFrames ) ; 
+	stats.numDuplicates = iisuAtomicLoad( &numDuplicates ) ; 
+	stats.numGaps = iisuAtomicLoad( &numGaps ) ; 
+	stats.numDroppedFrames = iisuAtomicLoad( &numDroppedFrames ) ; 
+	stats.numLatchedFrames = numLatchedFrames ; 
+	stats.numOverwrittenFrames = MAX( 0 , stats.numFrames - numLatchedFrames - 1 ) ;		//one can still be waiting
+	stats.numStalls = numStalls ; 
+	stats.bStalled = bStalled ; 
+	stats.lastIntervalMillis = lastIntervalMillis ; 
+	stats.averageIntervalMillis = averageIntervalMillis ; 
+	for ( int i = 0 ; i < IISU_JITTER_BINS ; i++ ) 
+		stats.jitterHistogram[i] = iisuAtomicLoad( &jitterHistogram[i] ) ; 
+	return stats ; 
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+	IisuFrameTracker
+	Keeps an eye on the frame IDs going through IisuServer. The producer side ( iisu's thread , or the replay thread )
+	counts frame ID gaps , duplicates and the inter arrival jitter , the app thread counts what it actually latched.
+	Camera frames lost before they reached us show up as dropped , frames we captured but the app never
+	picked up ( it was busy rendering ) as overwritten.
+
+	checkHealth() runs on the app thread from IisuServer::update() and is the only place that notifies :
+		DEVICE_STALLED		no new frame for stallMillis , args : milliseconds since the last one
+		DEVICE_RESUMED		frames are coming in again , args : how long the stall lasted in milliseconds
+		FRAMES_DROPPED		camera frames lost since the last report , at most once every reportMillis
+*/
+
+#include "ofMain.h"
+#include "IisuAtomic.h"
+#include "IisuEvents.h"
+
+//Inter arrival histogram , IISU_JITTER_BIN_MILLIS wide bins and everything slower in the last one
+#define IISU_JITTER_BINS 32
+#define IISU_JITTER_BIN_MILLIS 2
+
+struct IisuFrameStats
+{
+	int numFrames ;					//captured , duplicates not included
+	int numDuplicates ; 
+	int numGaps ;					//times the frame ID jumped by more than one
+	int numDroppedFrames ;			//camera frames lost in those jumps
+	int numLatchedFrames ;			//picked up by the app
+	int numOverwrittenFrames ;		//captured but replaced before the app picked them up
+	int numStalls ; 
+	bool bStalled ; 
+	float lastIntervalMillis ; 
+	float averageIntervalMillis ; 
+	int jitterHistogram[ IISU_JITTER_BINS ] ; 
+};
+
+class IisuFrameTracker
+{
+	public :
+		IisuFrameTracker( ) ; 
+
+		int stallMillis ;				//no frame for this long is a stall
+		int reportMillis ;				//FRAMES_DROPPED is batched up over this long
+
+		void reset( ) ; 
+
+		//Producer thread , once per published frame
+		void addFrame( int32_t frameID , unsigned long long micros ) ; 
+
+		//App thread
+		void addLatchedFrame( ) ; 
+		void checkHealth( unsigned long long micros ) ; 
+		bool isStalled( ) { return bStalled ; } 
+		IisuFrameStats getStats( ) ; 
+
+	protected :
+		//Written by the producer
+		int32_t lastFrameID ; 
+		unsigned long long lastArrivalMicros ; 
+		float lastIntervalMillis ; 
+		float averageIntervalMillis ; 
+		iisu_atomic_t numFrames ; 
+		iisu_atomic_t numDuplicates ; 
+		iisu_atomic_t numGaps ; 
+		iisu_atomic_t numDroppedFrames ; 
+		iisu_atomic_t lastArrivalMillis ;			//what the watchdog reads , wraps after ~24 days which it doesn't mind
+		iisu_atomic_t jitterHistogram[ IISU_JITTER_BINS ] ; 
+
+		//Written by the app thread
+		int numLatchedFrames ; 
+		int numStalls ; 
+		bool bStalled ; 
+		unsigned long long stallStartMicros ; 
+		int numReportedDroppedFrames ; 
+		unsigned long long lastReportMicros ; 
+};
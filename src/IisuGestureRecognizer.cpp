@@ -0,0 +1,498 @@
+#include "IisuGestureRecognizer.h"
+#include "IisuServer.h"
+
+void IisuGestureStream::add( const ofVec3f &sample , double time )
+{
+	samples[ head ] = sample ; 
+	times[ head ] = time ; 
+	head = ( head + 1 ) % IISU_GESTURE_HISTORY ; 
+	count = MIN( count + 1 , IISU_GESTURE_HISTORY ) ; 
+	total++ ; 
+}
+
+IisuGestureRecognizer::IisuGestureRecognizer( )
+{
+	threshold = 0.35f ; 
+	cooldown = 0.75f ; 
+	minExtent = 0.05f ; 
+	settle = 0.2f ; 
+	boundCost = 0.0f ; 
+	numPairedStreams = 0 ; 
+	numPairedTemplates = 0 ; 
+	lastFrameID = -1 ; 
+	numPruned = 0 ; 
+	numAbandoned = 0 ; 
+}
+
+void IisuGestureRecognizer::setup( int numThreads )
+{
+	pool.setup( numThreads ) ; 
+}
+
+int IisuGestureRecognizer::addJointStream( int user , int joint )
+{
+	IisuGestureStream stream ; 
+	stream.kind = IISU_GESTURE_JOINT ; 
+	stream.source = user ; 
+	stream.joint = joint ; 
+	stream.cooldownUntil = 0.0 ; 
+	stream.generation = 0 ; 
+	stream.clear( ) ; 
+	streams.push_back( stream ) ; 
+	return streams.size() - 1 ; 
+}
+
+int IisuGestureRecognizer::addCursorStream( int cursorID )
+{
+	int index = addJointStream( cursorID , -1 ) ; 
+	streams[ index ].kind = IISU_GESTURE_CURSOR ; 
+	return index ; 
+}
+
+void IisuGestureRecognizer::addSample( int stream , const ofVec3f &sample , double time )
+{
+	if ( stream >= 0 && stream < streams.size() )
+		streams[ stream ].add( sample , time ) ; 
+}
+
+bool IisuGestureRecognizer::resamplePoints( const ofVec3f * points , int numPoints , float * x , float * y , float * z , float * spacing )
+{
+	if ( numPoints < 2 )
+		return false ; 
+
+	float length = 0.0f ; 
+	for ( int i = 1 ; i < numPoints ; i++ )
+		length += points[i].distance( points[ i - 1 ] ) ; 
+	if ( length <= 0.0f )
+		return false ; 
+
+	//Evenly spaced along the path , like $1 / $P , so speed doesn't matter but shape does
+	float step = length / IISU_GESTURE_STEPS ; 
+	*spacing = step ; 
+	float travelled = 0.0f ; 
+	int segment = 1 ; 
+	for ( int n = 0 ; n < IISU_GESTURE_POINTS ; n++ )
+	{
+		float target = step * n ; 
+		float segmentLength = points[ segment ].distance( points[ segment - 1 ] ) ; 
+		while ( segment < numPoints - 1 && travelled + segmentLength < target )
+		{
+			travelled += segmentLength ; 
+			segment++ ; 
+			segmentLength = points[ segment ].distance( points[ segment - 1 ] ) ; 
+		}
+		float t = ( segmentLength > 0.0f ) ? ofClamp( ( target - travelled ) / segmentLength , 0.0f , 1.0f ) : 0.0f ; 
+		ofVec3f p = points[ segment - 1 ].getInterpolated( points[ segment ] , t ) ; 
+		x[n] = p.x ; 
+		y[n] = p.y ; 
+		z[n] = p.z ; 
+	}
+
+	//Centred and scaled by the largest extent so it doesn't matter where or how big it was done
+	ofVec3f minimum( x[0] , y[0] , z[0] ) , maximum( x[0] , y[0] , z[0] ) , centroid ; 
+	for ( int n = 0 ; n < IISU_GESTURE_POINTS ; n++ )
+	{
+		minimum.set( MIN( minimum.x , x[n] ) , MIN( minimum.y , y[n] ) , MIN( minimum.z , z[n] ) ) ; 
+		maximum.set( MAX( maximum.x , x[n] ) , MAX( maximum.y , y[n] ) , MAX( maximum.z , z[n] ) ) ; 
+		centroid += ofVec3f( x[n] , y[n] , z[n] ) ; 
+	}
+	centroid /= IISU_GESTURE_POINTS ; 
+	ofVec3f extent = maximum - minimum ; 
+	float scale = MAX( extent.x , MAX( extent.y , extent.z ) ) ; 
+	if ( scale <= 0.0f )
+		return false ; 
+
+	for ( int n = 0 ; n < IISU_GESTURE_POINTS ; n++ )
+	{
+		x[n] = ( x[n] - centroid.x ) / scale ; 
+		y[n] = ( y[n] - centroid.y ) / scale ; 
+		z[n] = ( z[n] - centroid.z ) / scale ; 
+	}
+	return true ; 
+}
+
+void IisuGestureRecognizer::buildDirections( IisuGestureTemplate &gesture )
+{
+	for ( int i = 0 ; i < IISU_GESTURE_STEPS ; i++ )
+	{
+		ofVec3f direction( gesture.x[ i + 1 ] - gesture.x[i] , gesture.y[ i + 1 ] - gesture.y[i] , gesture.z[ i + 1 ] - gesture.z[i] ) ; 
+		direction.normalize() ; 
+		gesture.dx[i] = direction.x ; 
+		gesture.dy[i] = direction.y ; 
+		gesture.dz[i] = direction.z ; 
+	}
+}
+
+int IisuGestureRecognizer::addTemplate( const string &name , IisuGestureStreamKind kind , int joint , const vector<ofVec3f> &points , float duration )
+{
+	IisuGestureTemplate gesture ; 
+	gesture.name = name ; 
+	gesture.kind = kind ; 
+	gesture.joint = joint ; 
+	gesture.duration = duration ; 
+	if ( points.size() < 2 || resamplePoints( &points[0] , points.size() , gesture.x , gesture.y , gesture.z , &gesture.spacing ) == false )
+	{
+		ofLog( OF_LOG_WARNING , "IisuGestureRecognizer::addTemplate " + name + " has no movement , skipped" ) ; 
+		return -1 ; 
+	}
+	buildDirections( gesture ) ; 
+	templates.push_back( gesture ) ; 
+	return templates.size() - 1 ; 
+}
+
+int IisuGestureRecognizer::recordTemplate( const string &name , int stream , float duration )
+{
+	if ( stream < 0 || stream >= streams.size() )
+		return -1 ; 
+
+	const IisuGestureStream &source = streams[ stream ] ; 
+	int newest = ( source.head - 1 + IISU_GESTURE_HISTORY ) % IISU_GESTURE_HISTORY ; 
+	double from = source.times[ newest ] - duration ; 
+	vector<ofVec3f> points ; 
+	for ( int i = source.count ; i > 0 ; i-- )
+	{
+		int index = ( source.head - i + IISU_GESTURE_HISTORY ) % IISU_GESTURE_HISTORY ; 
+		if ( source.times[ index ] >= from )
+			points.push_back( source.samples[ index ] ) ; 
+	}
+	return addTemplate( name , source.kind , source.joint , points , duration ) ; 
+}
+
+bool IisuGestureRecognizer::saveTemplates( const string &path )
+{
+	FILE * file = fopen( ofToDataPath( path ).c_str() , "w" ) ; 
+	if ( file == NULL )
+		return false ; 
+
+	//One template per line : name kind joint duration spacing , then x y z of every normalized point
+	for ( int i = 0 ; i < templates.size() ; i++ )
+	{
+		const IisuGestureTemplate &gesture = templates[i] ; 
+		string name = gesture.name ; 
+		ofStringReplace( name , " " , "_" ) ; 
+		fprintf( file , "%s %d %d %f %f" , name.c_str() , (int) gesture.kind , gesture.joint , gesture.duration , gesture.spacing ) ; 
+		for ( int n = 0 ; n < IISU_GESTURE_POINTS ; n++ )
+			fprintf( file , " %f %f %f" , gesture.x[n] , gesture.y[n] , gesture.z[n] ) ; 
+		fprintf( file , "\n" ) ; 
+	}
+	fclose( file ) ; 
+	return true ; 
+}
+
+bool IisuGestureRecognizer::loadTemplates( const string &path )
+{
+	FILE * file = fopen( ofToDataPath( path ).c_str() , "r" ) ; 
+	if ( file == NULL )
+		return false ; 
+
+	char name[256] ; 
+	int kind , joint ; 
+	float duration , spacing ; 
+	while ( fscanf( file , "%255s %d %d %f %f" , name , &kind , &joint , &duration , &spacing ) == 5 )
+	{
+		IisuGestureTemplate gesture ; 
+		gesture.name = name ; 
+		gesture.kind = (IisuGestureStreamKind) kind ; 
+		gesture.joint = joint ; 
+		gesture.duration = duration ; 
+		gesture.spacing = spacing ; 
+		bool bComplete = true ; 
+		for ( int n = 0 ; n < IISU_GESTURE_POINTS && bComplete ; n++ )
+			bComplete = ( fscanf( file , "%f %f %f" , &gesture.x[n] , &gesture.y[n] , &gesture.z[n] ) == 3 ) ; 
+		if ( bComplete == false )
+			break ; 
+		if ( spacing <= 0.0f )
+			continue ; 
+
+		buildDirections( gesture ) ; 
+		templates.push_back( gesture ) ; 
+	}
+	fclose( file ) ; 
+	return true ; 
+}
+
+void IisuGestureRecognizer::update( IisuServer * iisu )
+{
+	int wanted = IISU_STREAM_NONE ; 
+	for ( int i = 0 ; i < streams.size() ; i++ )
+		wanted |= ( streams[i].kind == IISU_GESTURE_JOINT ) ? IISU_STREAM_SKELETON : IISU_STREAM_CONTROLLERS ; 
+	subscription.set( iisu , wanted ) ; 
+
+	const IisuFrame &frame = iisu->getFrame() ; 
+	if ( frame.frameID == lastFrameID )
+		return ; 
+	lastFrameID = frame.frameID ; 
+
+	for ( int i = 0 ; i < streams.size() ; i++ )
+	{
+		IisuGestureStream &stream = streams[i] ; 
+		if ( stream.kind == IISU_GESTURE_JOINT )
+		{
+			const Vector3 * keyPoints = iisu->getUserKeyPoints( stream.source ) ; 
+			if ( keyPoints != NULL && iisu->getUserSkeletonStatus( stream.source ) != 0 )
+			{
+				const Vector3 &point = keyPoints[ stream.joint ] ; 
+				stream.add( ofVec3f( point.x , point.y , point.z ) , frame.timestamp ) ; 
+			}
+			else
+			{
+				stream.clear( ) ; 
+			}
+		}
+		else
+		{
+			if ( stream.source < frame.controllers.size() && frame.controllers[ stream.source ].isActive )
+			{
+				const Vector3 &point = frame.controllers[ stream.source ].normalizedCoordinates ; 
+				stream.add( ofVec3f( point.x , point.y , point.z ) , frame.timestamp ) ; 
+			}
+			else
+			{
+				stream.clear( ) ; 
+			}
+		}
+	}
+
+	match( frame.timestamp , frame.frameID ) ; 
+}
+
+void IisuGestureRecognizer::buildPairs( )
+{
+	//Pairs start from the streams as they are now , there's nothing to catch up on
+	pairs.clear() ; 
+	for ( int s = 0 ; s < streams.size() ; s++ )
+	{
+		const IisuGestureStream &stream = streams[s] ; 
+		for ( int t = 0 ; t < templates.size() ; t++ )
+		{
+			const IisuGestureTemplate &gesture = templates[t] ; 
+			if ( gesture.kind != stream.kind || ( stream.kind == IISU_GESTURE_JOINT && gesture.joint != stream.joint ) )
+				continue ; 
+
+			IisuGesturePair pair ; 
+			pair.stream = s ; 
+			pair.templateIndex = t ; 
+			pair.generation = stream.generation ; 
+			pair.consumed = stream.total ; 
+			pair.bAnchored = false ; 
+			pair.restart( ) ; 
+			pairs.push_back( pair ) ; 
+		}
+	}
+	numPairedStreams = streams.size() ; 
+	numPairedTemplates = templates.size() ; 
+}
+
+float IisuGestureRecognizer::getExtent( const IisuGestureStream &stream , int from , int to )
+{
+	//Samples from and to count from the stream's last clear() , the ring only has the last count of them
+	from = MAX( from , stream.total - stream.count ) ; 
+	if ( from > to )
+		return 0.0f ; 
+
+	const ofVec3f &first = stream.samples[ ( stream.head - ( stream.total - from ) + IISU_GESTURE_HISTORY ) % IISU_GESTURE_HISTORY ] ; 
+	ofVec3f minimum = first , maximum = first ; 
+	for ( int i = from + 1 ; i <= to ; i++ )
+	{
+		const ofVec3f &sample = stream.samples[ ( stream.head - ( stream.total - i ) + IISU_GESTURE_HISTORY ) % IISU_GESTURE_HISTORY ] ; 
+		minimum.set( MIN( minimum.x , sample.x ) , MIN( minimum.y , sample.y ) , MIN( minimum.z , sample.z ) ) ; 
+		maximum.set( MAX( maximum.x , sample.x ) , MAX( maximum.y , sample.y ) , MAX( maximum.z , sample.z ) ) ; 
+	}
+	ofVec3f extent = maximum - minimum ; 
+	return MAX( extent.x , MAX( extent.y , extent.z ) ) ; 
+}
+
+void IisuGestureRecognizer::match( double time , int frameID )
+{
+	matches.clear() ; 
+	if ( templates.size() == 0 || streams.size() == 0 )
+		return ; 
+	if ( numPairedStreams != streams.size() || numPairedTemplates != templates.size() )
+		buildPairs( ) ; 
+	if ( pairs.size() == 0 )
+		return ; 
+
+	boundCost = threshold * threshold * IISU_GESTURE_STEPS ; 
+	iisuAtomicStore( &numPruned , 0 ) ; 
+	iisuAtomicStore( &numAbandoned , 0 ) ; 
+
+	pool.run( this , pairs.size() ) ; 
+
+	for ( int s = 0 ; s < streams.size() ; s++ )
+	{
+		IisuGestureStream &stream = streams[s] ; 
+		int best = -1 ; 
+		for ( int i = 0 ; i < pairs.size() ; i++ )
+		{
+			if ( pairs[i].stream == s && pairs[i].heldCost < FLT_MAX && ( best < 0 || pairs[i].heldCost < pairs[ best ].heldCost ) )
+				best = i ; 
+		}
+		if ( best < 0 )
+			continue ; 
+
+		//SPRING over all the stream's templates : the best end is final once no live cell of any of them could still
+		//end lower on a path overlapping it , or once the stream stopped moving and nothing will
+		const IisuGesturePair &held = pairs[ best ] ; 
+		int newest = stream.total - 1 ; 
+		int oldest = newest ; 
+		while ( oldest > stream.total - stream.count && stream.times[ ( stream.head - ( stream.total - oldest + 1 ) + IISU_GESTURE_HISTORY ) % IISU_GESTURE_HISTORY ] >= time - settle )
+			oldest-- ; 
+		bool bFinal = ( oldest < newest && getExtent( stream , oldest , newest ) < minExtent ) ; 
+		if ( bFinal == false )
+		{
+			bFinal = true ; 
+			for ( int i = 0 ; i < pairs.size() && bFinal ; i++ )
+			{
+				const IisuGesturePair &pair = pairs[i] ; 
+				if ( pair.stream != s )
+					continue ; 
+				for ( int j = 0 ; j <= pair.last && bFinal ; j++ )
+					bFinal = ( pair.cost[j] >= held.heldCost || pair.start[j] > held.heldEnd ) ; 
+			}
+		}
+		if ( bFinal == false )
+			continue ; 
+
+		if ( time >= stream.cooldownUntil )
+		{
+			IisuGestureMatch found ; 
+			found.stream = s ; 
+			found.templateIndex = held.templateIndex ; 
+			found.name = templates[ found.templateIndex ].name ; 
+			found.distance = sqrtf( held.heldCost / IISU_GESTURE_STEPS ) ; 
+			found.frameID = frameID ; 
+			matches.push_back( found ) ; 
+			stream.cooldownUntil = time + cooldown ; 
+		}
+
+		//Whatever overlapped it is done too , the stream's pairs start over from here
+		for ( int i = 0 ; i < pairs.size() ; i++ )
+		{
+			if ( pairs[i].stream == s )
+				pairs[i].restart( ) ; 
+		}
+	}
+
+	for ( int i = 0 ; i < matches.size() ; i++ )
+		ofNotifyEvent( GESTURE_RECOGNIZED , matches[i] , this ) ; 
+}
+
+void IisuGestureRecognizer::runItems( int first , int count )
+{
+	for ( int i = first ; i < first + count ; i++ )
+		walk( pairs[i] ) ; 
+}
+
+void IisuGestureRecognizer::walk( IisuGesturePair &pair )
+{
+	const IisuGestureStream &stream = streams[ pair.stream ] ; 
+	const IisuGestureTemplate &gesture = templates[ pair.templateIndex ] ; 
+
+	//A cleared stream lost its user or cursor , nothing carries over
+	if ( pair.generation != stream.generation )
+	{
+		pair.generation = stream.generation ; 
+		pair.consumed = 0 ; 
+		pair.bAnchored = false ; 
+		pair.restart( ) ; 
+	}
+	int fresh = MIN( stream.total - pair.consumed , stream.count ) ; 
+	pair.consumed = stream.total ; 
+
+	int pruned = 0 ; 
+	int abandoned = 0 ; 
+	for ( int k = fresh ; k > 0 ; k-- )
+	{
+		int sample = stream.total - k ; 
+		const ofVec3f &position = stream.samples[ ( stream.head - k + IISU_GESTURE_HISTORY ) % IISU_GESTURE_HISTORY ] ; 
+		ofVec3f offset = position - pair.anchor ; 
+		float travelled = offset.length() ; 
+
+		//A whole template's worth in one sample is tracking jumping , not a gesture
+		if ( pair.bAnchored == false || travelled > gesture.spacing * IISU_GESTURE_STEPS )
+		{
+			pair.anchor = position ; 
+			pair.bAnchored = true ; 
+			pair.restart( ) ; 
+			continue ; 
+		}
+
+		//A point every spacing along the way , so speed doesn't matter
+		int numSteps = (int)( travelled / gesture.spacing ) ; 
+		if ( numSteps == 0 )
+			continue ; 
+		ofVec3f direction = offset / travelled ; 
+		for ( int n = 0 ; n < numSteps ; n++ )
+			addPoint( pair , gesture , direction , sample , pruned , abandoned ) ; 
+		pair.anchor += direction * ( gesture.spacing * numSteps ) ; 
+
+		//Best end so far , match() decides when it's final
+		if ( pair.last == IISU_GESTURE_STEPS - 1 && pair.cost[ pair.last ] < pair.heldCost && getExtent( stream , pair.start[ pair.last ] , sample ) >= minExtent )
+		{
+			pair.heldCost = pair.cost[ pair.last ] ; 
+			pair.heldStart = pair.start[ pair.last ] ; 
+			pair.heldEnd = sample ; 
+		}
+	}
+
+	if ( pruned > 0 )
+		iisuAtomicAdd( &numPruned , pruned ) ; 
+	if ( abandoned > 0 )
+		iisuAtomicAdd( &numAbandoned , abandoned ) ; 
+}
+
+void IisuGestureRecognizer::addPoint( IisuGesturePair &pair , const IisuGestureTemplate &gesture , const ofVec3f &direction , int sample , int &pruned , int &abandoned )
+{
+	int previousLast = pair.last ; 
+	pair.last = -1 ; 
+
+	//One new column in place. Row 0 can start on any point ( SPRING's free start ) , row i comes from row i - 1
+	//of this column , row i of the last one or row i - 1 of the last one , whichever is cheapest. Never twice
+	//from the row below , or a few points of stream could stand in for the whole template
+	float diagonal = 0.0f ; 
+	int diagonalStart = sample ; 
+	float up = FLT_MAX ; 
+	int upStart = sample ; 
+	bool bUpRose = false ; 
+	for ( int i = 0 ; i < IISU_GESTURE_STEPS ; i++ )
+	{
+		//Past the last column's live rows only this column's row below leads here , once that can't so can't the rest
+		if ( i > previousLast + 1 && ( up == FLT_MAX || bUpRose ) )
+		{
+			pruned += IISU_GESTURE_STEPS - i ; 
+			break ; 
+		}
+		float left = ( i <= previousLast ) ? pair.cost[i] : FLT_MAX ; 
+		int leftStart = pair.start[i] ; 
+
+		float step = diagonal ; 
+		int stepStart = diagonalStart ; 
+		bool bRose = false ; 
+		if ( left < step ) { step = left ; stepStart = leftStart ; }
+		if ( up < step && bUpRose == false ) { step = up ; stepStart = upStart ; bRose = true ; }
+		diagonal = left ; 
+		diagonalStart = leftStart ; 
+
+		//Costs only grow along a path , a cell over the threshold can't lead to a match
+		float value = FLT_MAX ; 
+		if ( step < FLT_MAX )
+		{
+			float ddx = direction.x - gesture.dx[i] ; 
+			float ddy = direction.y - gesture.dy[i] ; 
+			float ddz = direction.z - gesture.dz[i] ; 
+			value = step + ddx * ddx + ddy * ddy + ddz * ddz ; 
+			if ( value >= boundCost )
+			{
+				value = FLT_MAX ; 
+				abandoned++ ; 
+			}
+		}
+		pair.cost[i] = value ; 
+		pair.start[i] = stepStart ; 
+		if ( value < FLT_MAX )
+			pair.last = i ; 
+		up = value ; 
+		upStart = stepStart ; 
+		bUpRose = bRose ; 
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+/*
+	IisuGestureRecognizer
+	Template gestures over the key point and cursor streams. Every stream keeps its recent samples in a ring buffer ,
+	every stream x template pair walks the new samples at the template's point spacing and runs SPRING ( subsequence
+	DTW with a free start ) on the directions between points , one column per new point , so a frame only pays for
+	what came in since the last one. A stream's best end is reported once none of its templates could still beat it.
+	Cells that can't get under the threshold are dropped and the rows no live cell can reach are never computed ,
+	the pairs are shared out over an IisuWorkerPool.
+*/
+
+#include "ofMain.h"
+#include "IisuFrame.h"
+#include "IisuWorkerPool.h"
+#include "IisuServer.h"
+
+//Points per resampled template , DTW runs on the directions between them
+#define IISU_GESTURE_POINTS 32
+#define IISU_GESTURE_STEPS ( IISU_GESTURE_POINTS - 1 )
+#define IISU_GESTURE_HISTORY 256
+
+//What a stream follows , templates only match streams of the same kind
+enum IisuGestureStreamKind
+{
+	IISU_GESTURE_JOINT = 0 ,			//one key point of one user , world meters
+	IISU_GESTURE_CURSOR					//UI.CONTROLLER# normalized coordinates
+}; 
+
+struct IisuGestureMatch
+{
+	int stream ; 
+	int templateIndex ; 
+	string name ; 
+	float distance ;			//RMS over the template's directions , unit vectors so 0 .. 2
+	int frameID ;				//when it was reported , a few samples after the gesture ended
+}; 
+
+struct IisuGestureTemplate
+{
+	string name ; 
+	IisuGestureStreamKind kind ; 
+	int joint ;						//for IISU_GESTURE_JOINT
+	float duration ;				//seconds of stream it was recorded from
+	float spacing ;					//stream units between the points as recorded , streams are walked at this step
+
+	//Normalized points , structure of arrays , and the unit directions between them
+	float x[ IISU_GESTURE_POINTS ] , y[ IISU_GESTURE_POINTS ] , z[ IISU_GESTURE_POINTS ] ; 
+	float dx[ IISU_GESTURE_STEPS ] , dy[ IISU_GESTURE_STEPS ] , dz[ IISU_GESTURE_STEPS ] ; 
+}; 
+
+struct IisuGestureStream
+{
+	IisuGestureStreamKind kind ; 
+	int source ;				//user slot or cursor ID
+	int joint ; 
+
+	//Ring buffer , head is where the next sample goes
+	ofVec3f samples[ IISU_GESTURE_HISTORY ] ; 
+	double times[ IISU_GESTURE_HISTORY ] ; 
+	int head ; 
+	int count ; 
+	int total ;					//samples since the last clear() , the pairs keep up with this
+	int generation ;			//bumped by clear() so the pairs start over
+	double cooldownUntil ; 
+
+	void add( const ofVec3f &sample , double time ) ; 
+	void clear( ) { head = 0 ; count = 0 ; total = 0 ; generation++ ; }
+}; 
+
+//SPRING state of one stream against one template , carried from frame to frame
+struct IisuGesturePair
+{
+	int stream ; 
+	int templateIndex ; 
+	int generation ;			//of the stream when consumed was counted
+	int consumed ;				//stream samples already walked , samples count from the stream's last clear()
+	bool bAnchored ; 
+	ofVec3f anchor ;			//where the last point was put down
+
+	//The column of the newest point , rows past last are dead. start is the sample a cell's path began on
+	int last ; 
+	float cost[ IISU_GESTURE_STEPS ] ; 
+	int start[ IISU_GESTURE_STEPS ] ; 
+
+	//Cheapest end so far , match() reports it once nothing on the stream can beat it
+	float heldCost ; 
+	int heldStart , heldEnd ; 
+
+	void restart( ) { last = -1 ; heldCost = FLT_MAX ; }
+}; 
+
+class IisuGestureRecognizer : public IisuWorkerJob
+{
+	public :
+		IisuGestureRecognizer( ) ; 
+
+		//Extra threads for matching , 0 matches on the calling thread
+		void setup( int numThreads = 0 ) ; 
+
+		int addJointStream( int user , int joint ) ; 
+		int addCursorStream( int cursorID ) ; 
+		void addSample( int stream , const ofVec3f &sample , double time ) ; 
+
+		//From recorded points , or from what a stream did over the last duration seconds
+		int addTemplate( const string &name , IisuGestureStreamKind kind , int joint , const vector<ofVec3f> &points , float duration ) ; 
+		int recordTemplate( const string &name , int stream , float duration ) ; 
+		bool saveTemplates( const string &path ) ; 
+		bool loadTemplates( const string &path ) ; 
+
+		//Call once per app update() after IisuServer::update() , reads the streams' sources and matches on new frames
+		void update( IisuServer * iisu ) ; 
+		//Match now on whatever was added with addSample()
+		void match( double time , int frameID = -1 ) ; 
+
+		float threshold ;			//RMS distance a match has to get under
+		float cooldown ;			//seconds a stream is quiet after a match
+		float minExtent ;			//matches that moved less than this ( stream units ) are dropped
+		float settle ;				//seconds a stream has to keep still for before a match that could still grow is reported
+
+		vector<IisuGestureStream> streams ; 
+		vector<IisuGestureTemplate> templates ; 
+		vector<IisuGesturePair> pairs ;					//every stream against every template of its kind
+		vector<IisuGestureMatch> matches ;				//of the last match() call
+
+		ofEvent<IisuGestureMatch> GESTURE_RECOGNIZED ; 
+
+		//DTW cells of the last match() call that nothing live could reach , and that went over the threshold
+		int getNumPruned( ) { return iisuAtomicLoad( &numPruned ) ; }
+		int getNumAbandoned( ) { return iisuAtomicLoad( &numAbandoned ) ; }
+
+		void runItems( int first , int count ) ; 
+
+	protected :
+		static bool resamplePoints( const ofVec3f * points , int numPoints , float * x , float * y , float * z , float * spacing ) ; 
+		static void buildDirections( IisuGestureTemplate &gesture ) ; 
+		void buildPairs( ) ; 
+		void walk( IisuGesturePair &pair ) ; 
+		void addPoint( IisuGesturePair &pair , const IisuGestureTemplate &gesture , const ofVec3f &direction , int sample , int &pruned , int &abandoned ) ; 
+		float getExtent( const IisuGestureStream &stream , int from , int to ) ; 
+
+		float boundCost ;							//threshold as a DTW cost , set by match() for the workers
+		int numPairedStreams , numPairedTemplates ;	//what pairs was built for
+
+		int lastFrameID ; 
+		IisuSubscription subscription ;				//whatever the streams read , set in update()
+		iisu_atomic_t numPruned ; 
+		iisu_atomic_t numAbandoned ; 
+		IisuWorkerPool pool ; 
+}; 
@@ -0,0 +1,298 @@
+#include "IisuHoverTargets.h"
+
+//Keeps a few huge or far apart targets from making a huge grid
+#define IISU_HOVER_MAX_CELLS 16384
+
+IisuHoverTargets::IisuHoverTargets( )
+{
+	cellSize = 0.0f ; 
+	lastTime = 0.0 ; 
+	bGridDirty = true ; 
+	gridCellSize = 1.0f ; 
+	gridColumns = 0 ; 
+	gridRows = 0 ; 
+}
+
+void IisuHoverTargets::addTarget( int id , const ofRectangle &rect , float holdDelay )
+{
+	IisuHoverTarget target ; 
+	target.id = id ; 
+	target.rect = rect ; 
+	target.holdDelay = holdDelay ; 
+	target.bEnabled = true ; 
+	targets.push_back( target ) ; 
+	bGridDirty = true ; 
+}
+
+void IisuHoverTargets::setTargetRect( int id , const ofRectangle &rect )
+{
+	IisuHoverTarget * target = getTarget( id ) ; 
+	if ( target == NULL )
+		return ; 
+	target->rect = rect ; 
+	bGridDirty = true ; 
+}
+
+void IisuHoverTargets::setTargetEnabled( int id , bool bEnabled )
+{
+	IisuHoverTarget * target = getTarget( id ) ; 
+	if ( target == NULL || target->bEnabled == bEnabled )
+		return ; 
+	target->bEnabled = bEnabled ; 
+	bGridDirty = true ; 
+}
+
+void IisuHoverTargets::removeTarget( int id )
+{
+	//Cursors still over it get interrupted by the next update()
+	int index = findTarget( id ) ; 
+	if ( index < 0 )
+		return ; 
+	targets.erase( targets.begin() + index ) ; 
+	bGridDirty = true ; 
+}
+
+void IisuHoverTargets::clearTargets( )
+{
+	targets.clear() ; 
+	bGridDirty = true ; 
+}
+
+int IisuHoverTargets::findTarget( int id )
+{
+	for ( int i = 0 ; i < targets.size() ; i++ )
+	{
+		if ( targets[i].id == id )
+			return i ; 
+	}
+	return -1 ; 
+}
+
+IisuHoverTarget * IisuHoverTargets::getTarget( int id )
+{
+	int index = findTarget( id ) ; 
+	return ( index < 0 ) ? NULL : &targets[ index ] ; 
+}
+
+void IisuHoverTargets::addCursor( DepthCursor * cursor )
+{
+	if ( cursor == NULL || findState( cursor ) != NULL )
+		return ; 
+	IisuHoverState state ; 
+	state.cursor = cursor ; 
+	states.push_back( state ) ; 
+}
+
+void IisuHoverTargets::removeCursor( DepthCursor * cursor )
+{
+	for ( int i = 0 ; i < states.size() ; i++ )
+	{
+		if ( states[i].cursor == cursor )
+		{
+			hoverEnd( states[i] ) ; 
+			states.erase( states.begin() + i ) ; 
+			return ; 
+		}
+	}
+}
+
+IisuHoverState * IisuHoverTargets::findState( DepthCursor * cursor )
+{
+	for ( int i = 0 ; i < states.size() ; i++ )
+	{
+		if ( states[i].cursor == cursor )
+			return &states[i] ; 
+	}
+	return NULL ; 
+}
+
+void IisuHoverTargets::rebuildGrid( )
+{
+	bGridDirty = false ; 
+	cellStart.clear() ; 
+	cellTargets.clear() ; 
+	gridColumns = 0 ; 
+	gridRows = 0 ; 
+
+	int numEnabled = 0 ; 
+	float averageSize = 0.0f ; 
+	for ( int i = 0 ; i < targets.size() ; i++ )
+	{
+		const IisuHoverTarget &target = targets[i] ; 
+		if ( target.bEnabled == false || target.rect.width <= 0.0f || target.rect.height <= 0.0f )
+			continue ; 
+		if ( numEnabled == 0 )
+			gridBounds = target.rect ; 
+		else
+			gridBounds.growToInclude( target.rect ) ; 
+		averageSize += MAX( target.rect.width , target.rect.height ) ; 
+		numEnabled++ ; 
+	}
+	if ( numEnabled == 0 )
+		return ; 
+
+	//About one target per cell , then coarser until the grid fits
+	gridCellSize = ( cellSize > 0.0f ) ? cellSize : averageSize / numEnabled ; 
+	gridCellSize = MAX( gridCellSize , 8.0f ) ; 
+	for ( ; ; )
+	{
+		gridColumns = MAX( (int) ceilf( gridBounds.width / gridCellSize ) , 1 ) ; 
+		gridRows = MAX( (int) ceilf( gridBounds.height / gridCellSize ) , 1 ) ; 
+		if ( gridColumns * gridRows <= IISU_HOVER_MAX_CELLS )
+			break ; 
+		gridCellSize *= 2.0f ; 
+	}
+
+	//Counting pass then filling pass , every target goes in each cell it overlaps
+	int numCells = gridColumns * gridRows ; 
+	cellStart.assign( numCells + 1 , 0 ) ; 
+	for ( int pass = 0 ; pass < 2 ; pass++ )
+	{
+		for ( int i = 0 ; i < targets.size() ; i++ )
+		{
+			const IisuHoverTarget &target = targets[i] ; 
+			if ( target.bEnabled == false || target.rect.width <= 0.0f || target.rect.height <= 0.0f )
+				continue ; 
+			int column0 = ofClamp( (int) ( ( target.rect.x - gridBounds.x ) / gridCellSize ) , 0 , gridColumns - 1 ) ; 
+			int column1 = ofClamp( (int) ( ( target.rect.x + target.rect.width - gridBounds.x ) / gridCellSize ) , 0 , gridColumns - 1 ) ; 
+			int row0 = ofClamp( (int) ( ( target.rect.y - gridBounds.y ) / gridCellSize ) , 0 , gridRows - 1 ) ; 
+			int row1 = ofClamp( (int) ( ( target.rect.y + target.rect.height - gridBounds.y ) / gridCellSize ) , 0 , gridRows - 1 ) ; 
+			for ( int row = row0 ; row <= row1 ; row++ )
+			{
+				for ( int column = column0 ; column <= column1 ; column++ )
+				{
+					int cell = row * gridColumns + column ; 
+					if ( pass == 0 )
+						cellStart[ cell + 1 ]++ ; 
+					else
+						cellTargets[ cellStart[ cell ]++ ] = i ; 
+				}
+			}
+		}
+
+		if ( pass == 0 )
+		{
+			for ( int c = 0 ; c < numCells ; c++ )
+				cellStart[ c + 1 ] += cellStart[c] ; 
+			cellTargets.resize( cellStart[ numCells ] ) ; 
+		}
+		else
+		{
+			//Filling moved every start up to the next cell's , shift them back
+			for ( int c = numCells ; c > 0 ; c-- )
+				cellStart[c] = cellStart[ c - 1 ] ; 
+			cellStart[0] = 0 ; 
+		}
+	}
+}
+
+int IisuHoverTargets::hitTest( float x , float y )
+{
+	int index = hitTestIndex( x , y ) ; 
+	return ( index < 0 ) ? -1 : targets[ index ].id ; 
+}
+
+int IisuHoverTargets::hitTestIndex( float x , float y )
+{
+	if ( bGridDirty )
+		rebuildGrid( ) ; 
+	if ( gridColumns == 0 || gridBounds.inside( x , y ) == false )
+		return -1 ; 
+
+	int column = MIN( (int) ( ( x - gridBounds.x ) / gridCellSize ) , gridColumns - 1 ) ; 
+	int row = MIN( (int) ( ( y - gridBounds.y ) / gridCellSize ) , gridRows - 1 ) ; 
+	int cell = row * gridColumns + column ; 
+
+	//Targets are in the cell in the order they were added , the last one that contains the point is on top
+	int found = -1 ; 
+	for ( int i = cellStart[ cell ] ; i < cellStart[ cell + 1 ] ; i++ )
+	{
+		if ( targets[ cellTargets[i] ].rect.inside( x , y ) )
+			found = cellTargets[i] ; 
+	}
+	return found ; 
+}
+
+void IisuHoverTargets::update( double time )
+{
+	lastTime = time ; 
+	for ( int i = 0 ; i < states.size() ; i++ )
+	{
+		IisuHoverState &state = states[i] ; 
+		int index = state.cursor->bActive ? hitTestIndex( state.cursor->position.x , state.cursor->position.y ) : -1 ; 
+		int id = ( index < 0 ) ? -1 : targets[ index ].id ; 
+
+		if ( id != state.target )
+		{
+			hoverEnd( state ) ; 
+			if ( index >= 0 )
+				hoverStart( state , targets[ index ] , time ) ; 
+			continue ; 
+		}
+
+		if ( state.target != -1 && state.bFinished == false && time - state.startTime >= state.holdDelay )
+		{
+			state.bFinished = true ; 
+			IisuEventArgs args( state.target , state.holdDelay , state.cursor->cursorID ) ; 
+			ofNotifyEvent( IisuEvents::Instance()->CURSOR_HOVER_FINISHED , args ) ; 
+		}
+	}
+}
+
+void IisuHoverTargets::hoverStart( IisuHoverState &state , const IisuHoverTarget &target , double time )
+{
+	state.target = target.id ; 
+	state.holdDelay = target.holdDelay ; 
+	state.startTime = time ; 
+	state.bFinished = false ; 
+	IisuEventArgs args( target.id , target.holdDelay , state.cursor->cursorID ) ; 
+	ofNotifyEvent( IisuEvents::Instance()->CURSOR_HOVER_START , args ) ; 
+}
+
+void IisuHoverTargets::hoverEnd( IisuHoverState &state )
+{
+	IisuEventArgs args( state.target , state.holdDelay , state.cursor->cursorID ) ; 
+	bool bInterrupted = ( state.target != -1 && state.bFinished == false ) ; 
+	state.target = -1 ; 
+	state.bFinished = false ; 
+	if ( bInterrupted )
+		ofNotifyEvent( IisuEvents::Instance()->CURSOR_HOVER_INTERRUPTED , args ) ; 
+}
+
+int IisuHoverTargets::getHoveredTarget( DepthCursor * cursor )
+{
+	IisuHoverState * state = findState( cursor ) ; 
+	return ( state == NULL ) ? -1 : state->target ; 
+}
+
+float IisuHoverTargets::getHoverProgress( DepthCursor * cursor )
+{
+	IisuHoverState * state = findState( cursor ) ; 
+	if ( state == NULL || state->target == -1 )
+		return 0.0f ; 
+	if ( state->bFinished || state->holdDelay <= 0.0f )
+		return 1.0f ; 
+	return ofClamp( ( lastTime - state->startTime ) / state->holdDelay , 0.0f , 1.0f ) ; 
+}
+
+void IisuHoverTargets::debugDraw( )
+{
+	ofPushStyle() ; 
+	ofNoFill() ; 
+	for ( int i = 0 ; i < targets.size() ; i++ )
+	{
+		ofSetColor( targets[i].bEnabled ? ofColor( 255 , 255 , 255 ) : ofColor( 96 , 96 , 96 ) ) ; 
+		ofRect( targets[i].rect ) ; 
+	}
+	for ( int i = 0 ; i < states.size() ; i++ )
+	{
+		IisuHoverTarget * target = getTarget( states[i].target ) ; 
+		if ( target == NULL )
+			continue ; 
+		ofSetColor( states[i].cursor->color ) ; 
+		ofFill() ; 
+		ofRect( target->rect.x , target->rect.y , target->rect.width * getHoverProgress( states[i].cursor ) , 4 ) ; 
+		ofNoFill() ; 
+	}
+	ofPopStyle() ; 
+}
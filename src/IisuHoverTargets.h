@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+	IisuHoverTargets
+	Screen rectangles that cursors can dwell on. update() looks every active cursor up in a uniform grid over the
+	targets , so a frame costs one cell per cursor however many buttons the menu has , and runs one dwell timer per
+	cursor : CURSOR_HOVER_START when a cursor enters a target , CURSOR_HOVER_FINISHED once it stayed holdDelay
+	seconds and CURSOR_HOVER_INTERRUPTED if it left or got lost before that. Event args carry the target ID
+	( inputHex ) and the cursor's cursorID , so two cursors on the same button can be told apart.
+*/
+
+#include "ofMain.h"
+#include "IisuEvents.h"
+#include "DepthCursor.h"
+
+struct IisuHoverTarget
+{
+	int id ;						//what the events carry , IisuEventArgs::inputHex
+	ofRectangle rect ;				//window coordinates , like DepthCursor::position
+	float holdDelay ;				//seconds
+	bool bEnabled ; 
+}; 
+
+//What one cursor is doing
+struct IisuHoverState
+{
+	IisuHoverState( ) { cursor = NULL ; target = -1 ; holdDelay = 0.0f ; startTime = 0.0 ; bFinished = false ; }
+
+	DepthCursor * cursor ; 
+	int target ;					//target ID , -1 over nothing
+	float holdDelay ;				//the target's , when the cursor got there
+	double startTime ; 
+	bool bFinished ; 
+}; 
+
+class IisuHoverTargets
+{
+	public :
+		IisuHoverTargets( ) ; 
+
+		//IDs should be unique , where targets overlap the one added last wins
+		void addTarget( int id , const ofRectangle &rect , float holdDelay ) ; 
+		void setTargetRect( int id , const ofRectangle &rect ) ; 
+		void setTargetEnabled( int id , bool bEnabled ) ; 
+		void removeTarget( int id ) ; 
+		void clearTargets( ) ; 
+		IisuHoverTarget * getTarget( int id ) ; 
+
+		//DepthCursor and HandCursor , their position and bActive are read every update()
+		void addCursor( DepthCursor * cursor ) ; 
+		void removeCursor( DepthCursor * cursor ) ; 
+
+		//App thread , after the cursors' own update()
+		void update( ) { update( ofGetElapsedTimef() ) ; }
+		void update( double time ) ; 
+		void debugDraw( ) ; 
+
+		//ID of the target under a point , -1 if none
+		int hitTest( float x , float y ) ; 
+
+		//0 .. 1 of the hold delay , for drawing dwell rings
+		int getHoveredTarget( DepthCursor * cursor ) ; 
+		float getHoverProgress( DepthCursor * cursor ) ; 
+
+		//Grid cell size in pixels , 0 picks the average target size
+		float cellSize ; 
+
+	protected :
+		void rebuildGrid( ) ; 
+		int findTarget( int id ) ; 
+		int hitTestIndex( float x , float y ) ; 
+		IisuHoverState * findState( DepthCursor * cursor ) ; 
+		void hoverStart( IisuHoverState &state , const IisuHoverTarget &target , double time ) ; 
+		void hoverEnd( IisuHoverState &state ) ; 
+
+		vector<IisuHoverTarget> targets ; 
+		vector<IisuHoverState> states ; 
+		double lastTime ; 
+
+		//Grid , cell c holds cellTargets[ cellStart[c] .. cellStart[c + 1] ) , indices into targets
+		bool bGridDirty ; 
+		ofRectangle gridBounds ; 
+		float gridCellSize ; 
+		int gridColumns , gridRows ; 
+		vector<int> cellStart ; 
+		vector<int> cellTargets ; 
+}; 
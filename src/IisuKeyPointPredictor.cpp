@@ -0,0 +1,104 @@
+#include "IisuKeyPointPredictor.h"
+
+void IisuKeyPointPredictor::reset( ) 
+{
+	numFrames = 0 ; 
+	for ( int i = 0 ; i < 3 ; i++ ) 
+		times[i] = -1.0 ; 
+	for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+	{
+		confidence[j] = 0.0f ; 
+		velocity[j] = Vector3( 0 , 0 , 0 ) ; 
+		acceleration[j] = Vector3( 0 , 0 , 0 ) ; 
+		boneLength[j] = 0.0f ; 
+	}
+}
+
+void IisuKeyPointPredictor::addFrame( double time , const Vector3 * keyPoints , const float * _confidence ) 
+{
+	if ( keyPoints == NULL || ( numFrames > 0 && time <= times[0] ) ) 
+		return ; 
+
+	for ( int i = 2 ; i > 0 ; i-- ) 
+	{
+		times[i] = times[i - 1] ; 
+		for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+			history[i][j] = history[i - 1][j] ; 
+	}
+	times[0] = time ; 
+	for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+	{
+		history[0][j] = keyPoints[j] ; 
+		confidence[j] = ( _confidence != NULL ) ? _confidence[j] : 1.0f ; 
+	}
+	numFrames = MIN( numFrames + 1 , 3 ) ; 
+
+	//Bone lengths settle over a few frames , iisu's own estimate wobbles
+	for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+	{
+		int parent = iisuJointParent( j ) ; 
+		if ( parent < 0 ) 
+			continue ; 
+		float length = ( history[0][j] - history[0][ parent ] ).length() ; 
+		boneLength[j] = ( numFrames == 1 ) ? length : boneLength[j] + ( length - boneLength[j] ) * 0.1f ; 
+	}
+
+	if ( numFrames < 2 ) 
+		return ; 
+
+	float dt0 = (float) ( times[0] - times[1] ) ; 
+	for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+	{
+		Vector3 newVelocity = ( history[0][j] - history[1][j] ) / dt0 ; 
+		if ( numFrames == 3 ) 
+		{
+			float dt1 = (float) ( times[1] - times[2] ) ; 
+			Vector3 lastVelocity = ( history[1][j] - history[2][j] ) / dt1 ; 
+			acceleration[j] = ( newVelocity - lastVelocity ) / ( ( dt0 + dt1 ) * 0.5f ) ; 
+		}
+		velocity[j] = newVelocity ; 
+	}
+}
+
+const Vector3 * IisuKeyPointPredictor::predict( double targetTime ) 
+{
+	if ( numFrames == 0 ) 
+	{
+		for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+			predicted[j] = Vector3( 0 , 0 , 0 ) ; 
+		return predicted ; 
+	}
+
+	float ahead = ofClamp( (float) ( targetTime - times[0] ) , 0.0f , maxPredictionSeconds ) ; 
+	if ( numFrames < 2 || ahead <= 0.0f ) 
+	{
+		for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+			predicted[j] = history[0][j] ; 
+		return predicted ; 
+	}
+
+	float confidenceRange = MAX( 1.0f - minConfidence , 0.0001f ) ; 
+	for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+	{
+		//Unsure joints stay closer to where they were measured
+		float weight = ofClamp( ( confidence[j] - minConfidence ) / confidenceRange , 0.0f , 1.0f ) ; 
+		float t = ahead * weight ; 
+		predicted[j] = history[0][j] + velocity[j] * t + acceleration[j] * ( 0.5f * accelerationWeight * t * t ) ; 
+	}
+
+	if ( bConstrainBones ) 
+	{
+		//Parents come first so each joint hangs off its already corrected parent
+		for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+		{
+			int parent = iisuJointParent( j ) ; 
+			if ( parent < 0 || boneLength[j] <= 0.0f ) 
+				continue ; 
+			Vector3 bone = predicted[j] - predicted[ parent ] ; 
+			float length = bone.length() ; 
+			if ( length > 0.00001f ) 
+				predicted[j] = predicted[ parent ] + bone * ( boneLength[j] / length ) ; 
+		}
+	}
+	return predicted ; 
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+	IisuKeyPointPredictor
+	Pushes one user's key points ahead to when they'll actually be on screen. Velocity and acceleration per joint
+	come from the last three frames , how far a joint is pushed shrinks with its confidence and every bone is put
+	back to its measured length afterwards so limbs don't stretch. Trades a little accuracy for less perceived lag.
+*/
+
+#include "ofMain.h"
+#include "IisuFrame.h"
+
+class IisuKeyPointPredictor
+{
+	public :
+		IisuKeyPointPredictor( ) 
+		{
+			maxPredictionSeconds = 0.1f ; 
+			minConfidence = 0.2f ; 
+			accelerationWeight = 0.5f ; 
+			bConstrainBones = true ; 
+			reset( ) ; 
+		}
+
+		//time in seconds like IisuFrame::timestamp , frames that aren't newer than the last one are ignored
+		void addFrame( double time , const Vector3 * keyPoints , const float * confidence ) ; 
+		void reset( ) ; 
+
+		//IISU_NUM_JOINTS key points at targetTime , the newest frame as is until there are two frames
+		const Vector3 * predict( double targetTime ) ; 
+		bool hasFrame( ) { return ( numFrames > 0 ) ; } 
+		double getLastTime( ) { return times[0] ; } 
+
+		float maxPredictionSeconds ;		//never look further ahead than this
+		float minConfidence ;				//joints at or under this aren't extrapolated at all
+		float accelerationWeight ;			//0 for velocity only , acceleration is the noisier term
+		bool bConstrainBones ; 
+
+	protected :
+		//[0] is the newest frame
+		Vector3 history[3][ IISU_NUM_JOINTS ] ; 
+		double times[3] ; 
+		int numFrames ; 
+
+		float confidence[ IISU_NUM_JOINTS ] ; 
+		Vector3 velocity[ IISU_NUM_JOINTS ] ; 
+		Vector3 acceleration[ IISU_NUM_JOINTS ] ; 
+		float boneLength[ IISU_NUM_JOINTS ] ;		//to the parent , averaged over frames
+		Vector3 predicted[ IISU_NUM_JOINTS ] ; 
+};
@@ -0,0 +1,184 @@
+#include "IisuLabelTexture.h"
+
+enum 
+{
+	LABEL_DRAW_SCENE = 0 , 
+	LABEL_DRAW_USER = 1
+};
+
+IisuLabelTexture::IisuLabelTexture( ) 
+{
+	width = 0 ; 
+	height = 0 ; 
+	bUsePixelBuffers = false ; 
+	pixelBuffers[0] = pixelBuffers[1] = 0 ; 
+	pixelBufferIndex = 0 ; 
+	maskUserID = -1 ; 
+	maskPreviousUserID = -1 ; 
+	bShaderReady = false ; 
+	memset( maskValues , 0 , 256 ) ; 
+}
+
+IisuLabelTexture::~IisuLabelTexture( ) 
+{
+	if ( bUsePixelBuffers ) 
+		glDeleteBuffers( 2 , pixelBuffers ) ; 
+}
+
+void IisuLabelTexture::allocate( int _width , int _height ) 
+{
+	width = _width ; 
+	height = _height ; 
+
+	//Plain GL_TEXTURE_2D so the shader can use normalized coordinates for both textures
+	labelTexture.allocate( width , height , GL_LUMINANCE , false ) ; 
+	labelTexture.setTextureMinMagFilter( GL_NEAREST , GL_NEAREST ) ; 
+
+	maskLookup.allocate( 256 , 1 , GL_LUMINANCE , false ) ; 
+	maskLookup.setTextureMinMagFilter( GL_NEAREST , GL_NEAREST ) ; 
+	maskLookup.setTextureWrap( GL_CLAMP_TO_EDGE , GL_CLAMP_TO_EDGE ) ; 
+	maskLookup.loadData( maskValues , 256 , 1 , GL_LUMINANCE ) ; 
+
+	if ( bUsePixelBuffers ) 
+		glDeleteBuffers( 2 , pixelBuffers ) ; 
+
+	bUsePixelBuffers = ( GLEW_ARB_pixel_buffer_object != 0 ) ; 
+	if ( bUsePixelBuffers ) 
+	{
+		glGenBuffers( 2 , pixelBuffers ) ; 
+		for ( int i = 0 ; i < 2 ; i++ ) 
+		{
+			glBindBuffer( GL_PIXEL_UNPACK_BUFFER , pixelBuffers[i] ) ; 
+			glBufferData( GL_PIXEL_UNPACK_BUFFER , width * height , NULL , GL_STREAM_DRAW ) ; 
+		}
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER , 0 ) ; 
+	}
+
+	setupShader( ) ; 
+}
+
+void IisuLabelTexture::loadLabels( const unsigned char * labels , int _width , int _height ) 
+{
+	if ( _width != width || _height != height ) 
+		allocate( _width , _height ) ; 
+
+	//Rows are tightly packed , one byte per pixel
+	glPixelStorei( GL_UNPACK_ALIGNMENT , 1 ) ; 
+
+	if ( bUsePixelBuffers == false ) 
+	{
+		//The driver copies straight out of the frame
+		labelTexture.loadData( labels , width , height , GL_LUMINANCE ) ; 
+		return ; 
+	}
+
+	//Fill one buffer while the other may still be feeding last frame's texture upload
+	pixelBufferIndex = 1 - pixelBufferIndex ; 
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER , pixelBuffers[ pixelBufferIndex ] ) ; 
+
+	//Orphan the old storage so mapping never stalls
+	glBufferData( GL_PIXEL_UNPACK_BUFFER , width * height , NULL , GL_STREAM_DRAW ) ; 
+	void * mapped = glMapBuffer( GL_PIXEL_UNPACK_BUFFER , GL_WRITE_ONLY ) ; 
+	if ( mapped != NULL ) 
+	{
+		memcpy( mapped , labels , width * height ) ; 
+		glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) ; 
+
+		//With a pixel buffer bound the data pointer is an offset into it
+		glBindTexture( labelTexture.texData.textureTarget , labelTexture.texData.textureID ) ; 
+		glTexSubImage2D( labelTexture.texData.textureTarget , 0 , 0 , 0 , width , height , GL_LUMINANCE , GL_UNSIGNED_BYTE , 0 ) ; 
+		glBindTexture( labelTexture.texData.textureTarget , 0 ) ; 
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER , 0 ) ; 
+	}
+	else
+	{
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER , 0 ) ; 
+		labelTexture.loadData( labels , width , height , GL_LUMINANCE ) ; 
+	}
+}
+
+void IisuLabelTexture::setUserLabels( int userID , int previousUserID ) 
+{
+	if ( userID == maskUserID && previousUserID == maskPreviousUserID ) 
+		return ; 
+
+	maskUserID = userID ; 
+	maskPreviousUserID = previousUserID ; 
+
+	memset( maskValues , 0 , 256 ) ; 
+
+	//Scene IDs of 250 and up aren't users
+	if ( userID < 250 ) 
+	{
+		if ( userID >= 0 ) 
+			maskValues[ userID ] = 255 ; 
+		if ( previousUserID >= 0 && previousUserID < 256 ) 
+			maskValues[ previousUserID ] = 255 ; 
+	}
+
+	maskLookup.loadData( maskValues , 256 , 1 , GL_LUMINANCE ) ; 
+}
+
+void IisuLabelTexture::drawScene( float x , float y , float width , float height , bool bMirror ) 
+{
+	draw( LABEL_DRAW_SCENE , x , y , width , height , bMirror ) ; 
+}
+
+void IisuLabelTexture::drawUser( float x , float y , float width , float height , bool bMirror ) 
+{
+	draw( LABEL_DRAW_USER , x , y , width , height , bMirror ) ; 
+}
+
+void IisuLabelTexture::draw( int mode , float x , float y , float _width , float _height , bool bMirror ) 
+{
+	if ( bShaderReady == false ) 
+		return ; 
+
+	shader.begin( ) ; 
+	shader.setUniformTexture( "labels" , labelTexture , 0 ) ; 
+	shader.setUniformTexture( "maskLookup" , maskLookup , 1 ) ; 
+	shader.setUniform1i( "mode" , mode ) ; 
+
+	//A negative width runs the texture coordinates right to left
+	if ( bMirror ) 
+		labelTexture.draw( x + _width , y , -_width , _height ) ; 
+	else
+		labelTexture.draw( x , y , _width , _height ) ; 
+
+	shader.end( ) ; 
+}
+
+void IisuLabelTexture::setupShader( ) 
+{
+	if ( bShaderReady ) 
+		return ; 
+
+	string vertexSource = 
+		"void main()\n"
+		"{\n"
+		"	gl_TexCoord[0] = gl_MultiTexCoord0 ;\n"
+		"	gl_FrontColor = gl_Color ;\n"
+		"	gl_Position = ftransform() ;\n"
+		"}\n" ; 
+
+	//Scene draws the raw label value as brightness , user draws the looked up mask.
+	//Labels are sampled at texel centers of the 256 wide lookup so value n maps to entry n exactly
+	string fragmentSource = 
+		"uniform sampler2D labels ;\n"
+		"uniform sampler2D maskLookup ;\n"
+		"uniform int mode ;\n"
+		"void main()\n"
+		"{\n"
+		"	float label = texture2D( labels , gl_TexCoord[0].st ).r ;\n"
+		"	float value = label ;\n"
+		"	if ( mode == 1 )\n"
+		"		value = texture2D( maskLookup , vec2( ( label * 255.0 + 0.5 ) / 256.0 , 0.5 ) ).r ;\n"
+		"	gl_FragColor = vec4( gl_Color.rgb * value , gl_Color.a ) ;\n"
+		"}\n" ; 
+
+	shader.setupShaderFromSource( GL_VERTEX_SHADER , vertexSource ) ; 
+	shader.setupShaderFromSource( GL_FRAGMENT_SHADER , fragmentSource ) ; 
+	bShaderReady = shader.linkProgram( ) ; 
+	if ( bShaderReady == false ) 
+		ofLog( OF_LOG_ERROR , "IisuLabelTexture : could not link the label shader" ) ; 
+}
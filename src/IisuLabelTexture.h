@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+	IisuLabelTexture
+	Streams SCENE.LabelImage to the GPU with one copy per frame. The label bytes go straight from the
+	frame into a pixel buffer object ( two of them , so we never wait on the upload of the last frame )
+	and the texture is filled from there by the driver.
+	Nothing is mirrored or thresholded on the CPU : mirroring is done with the texture coordinates and
+	the user mask is a 256 entry lookup table ( label value -> mask ) applied in the shader.
+*/
+
+#include "ofMain.h"
+
+class IisuLabelTexture
+{
+	public :
+		IisuLabelTexture( ) ; 
+		~IisuLabelTexture( ) ; 
+
+		void allocate( int _width , int _height ) ; 
+		void loadLabels( const unsigned char * labels , int _width , int _height ) ; 
+
+		//Labels that show up as the user , everything else is masked out. Only touches the GPU when it changes
+		void setUserLabels( int userID , int previousUserID ) ; 
+
+		//bMirror flips horizontally like the old ofImage::mirror( false , true )
+		void drawScene( float x , float y , float width , float height , bool bMirror = true ) ; 
+		void drawUser( float x , float y , float width , float height , bool bMirror = true ) ; 
+
+		int getWidth( ) { return width ; } 
+		int getHeight( ) { return height ; } 
+
+		ofTexture & getTextureReference( ) { return labelTexture ; } 
+
+	protected :
+		void draw( int mode , float x , float y , float width , float height , bool bMirror ) ; 
+		void setupShader( ) ; 
+
+		int width , height ; 
+		bool bUsePixelBuffers ; 
+		GLuint pixelBuffers[2] ; 
+		int pixelBufferIndex ; 
+
+		ofTexture labelTexture ; 
+		ofTexture maskLookup ;				//256 x 1 , one byte per label value
+		unsigned char maskValues[256] ; 
+		int maskUserID , maskPreviousUserID ; 
+
+		ofShader shader ; 
+		bool bShaderReady ; 
+};
@@ -0,0 +1,181 @@
+#include "IisuParameters.h"
+
+IisuParameterEntry& IisuParameterProfile::entry( const string &path , IisuParameterType type )
+{
+	//Setting a path twice keeps the last value , like applying it twice would
+	for ( int i = 0 ; i < entries.size() ; i++ )
+	{
+		if ( entries[i].path == path )
+		{
+			entries[i].type = type ; 
+			return entries[i] ; 
+		}
+	}
+
+	IisuParameterEntry added ; 
+	added.path = path ; 
+	added.type = type ; 
+	added.boolValue = false ; 
+	added.intValue = 0 ; 
+	added.floatValue = 0.0f ; 
+	entries.push_back( added ) ; 
+	return entries.back() ; 
+}
+
+IisuParameterProfile& IisuParameterProfile::set( const string &path , bool value )
+{
+	entry( path , IISU_PARAMETER_BOOL ).boolValue = value ; 
+	return *this ; 
+}
+
+IisuParameterProfile& IisuParameterProfile::set( const string &path , int32_t value )
+{
+	entry( path , IISU_PARAMETER_INT ).intValue = value ; 
+	return *this ; 
+}
+
+IisuParameterProfile& IisuParameterProfile::set( const string &path , float value )
+{
+	entry( path , IISU_PARAMETER_FLOAT ).floatValue = value ; 
+	return *this ; 
+}
+
+IisuParameters::IisuParameters( )
+{
+	device = NULL ; 
+	addDefaultProfiles( ) ; 
+}
+
+void IisuParameters::addDefaultProfiles( )
+{
+	//What IisuServer always set up : circle activation , controller gestures and the centroids
+	IisuParameterProfile defaults( "default" ) ; 
+	defaults.set( "UI.ACTIVATIONGESTURE.CIRCLE.Enabled" , true )
+		.set( "UI.CONTROLLERS.GESTURES.Enabled" , true )
+		.set( "UI.CONTROLLERS.GESTURES.CIRCLE.Enabled" , true )
+		.set( "SHAPE.CENTROIDS.Count" , 150 ) ; 
+	addProfile( defaults ) ; 
+
+	//Hands in front of the camera , the controller gestures would only fire by accident
+	IisuParameterProfile closeRange( "close-range" ) ; 
+	closeRange.set( "CI.Enabled" , true )
+		.set( "UI.CONTROLLERS.GESTURES.Enabled" , false )
+		.set( "UI.CONTROLLERS.GESTURES.CIRCLE.Enabled" , false ) ; 
+	addProfile( closeRange ) ; 
+
+	//Whole bodies further away , everybody can still grab a controller with a circle
+	IisuParameterProfile crowd( "crowd" ) ; 
+	crowd.set( "CI.Enabled" , false )
+		.set( "UI.ACTIVATIONGESTURE.CIRCLE.Enabled" , true )
+		.set( "UI.CONTROLLERS.GESTURES.Enabled" , true )
+		.set( "SHAPE.CENTROIDS.Count" , 100 ) ; 
+	addProfile( crowd ) ; 
+
+	//Least work per frame for iisu
+	IisuParameterProfile lowPower( "low-power" ) ; 
+	lowPower.set( "CI.Enabled" , false )
+		.set( "UI.CONTROLLERS.GESTURES.Enabled" , false )
+		.set( "UI.CONTROLLERS.GESTURES.CIRCLE.Enabled" , false )
+		.set( "SHAPE.CENTROIDS.Count" , 50 ) ; 
+	addProfile( lowPower ) ; 
+}
+
+void IisuParameters::setup( SK::Device * _device )
+{
+	device = _device ; 
+	for ( map< string , IisuParameter<bool> >::iterator it = bools.begin() ; it != bools.end() ; ++it )
+		it->second.setup( device , it->first ) ; 
+	for ( map< string , IisuParameter<int32_t> >::iterator it = ints.begin() ; it != ints.end() ; ++it )
+		it->second.setup( device , it->first ) ; 
+	for ( map< string , IisuParameter<float> >::iterator it = floats.begin() ; it != floats.end() ; ++it )
+		it->second.setup( device , it->first ) ; 
+}
+
+void IisuParameters::refresh( )
+{
+	for ( map< string , IisuParameter<bool> >::iterator it = bools.begin() ; it != bools.end() ; ++it )
+		it->second.refresh( ) ; 
+	for ( map< string , IisuParameter<int32_t> >::iterator it = ints.begin() ; it != ints.end() ; ++it )
+		it->second.refresh( ) ; 
+	for ( map< string , IisuParameter<float> >::iterator it = floats.begin() ; it != floats.end() ; ++it )
+		it->second.refresh( ) ; 
+}
+
+IisuParameter<bool>& IisuParameters::getBool( const string &path )
+{
+	return find( bools , path ) ; 
+}
+
+IisuParameter<int32_t>& IisuParameters::getInt( const string &path )
+{
+	return find( ints , path ) ; 
+}
+
+IisuParameter<float>& IisuParameters::getFloat( const string &path )
+{
+	return find( floats , path ) ; 
+}
+
+void IisuParameters::addProfile( const IisuParameterProfile &profile )
+{
+	IisuParameterProfile * existing = getProfile( profile.name ) ; 
+	if ( existing != NULL )
+		*existing = profile ; 
+	else
+		profiles.push_back( profile ) ; 
+}
+
+IisuParameterProfile * IisuParameters::getProfile( const string &name )
+{
+	for ( int i = 0 ; i < profiles.size() ; i++ )
+	{
+		if ( profiles[i].name == name )
+			return &profiles[i] ; 
+	}
+	return NULL ; 
+}
+
+bool IisuParameters::apply( const string &name )
+{
+	IisuParameterProfile * profile = getProfile( name ) ; 
+	if ( profile == NULL )
+	{
+		cout << "IisuParameters::apply :: no profile named " << name << endl ; 
+		return false ; 
+	}
+	return apply( *profile ) ; 
+}
+
+bool IisuParameters::apply( const IisuParameterProfile &profile )
+{
+	unsigned long long start = ofGetElapsedTimeMicros() ; 
+	lastApply = IisuParameterApplyStats() ; 
+	lastApply.profile = profile.name ; 
+
+	for ( int i = 0 ; i < profile.entries.size() ; i++ )
+	{
+		const IisuParameterEntry &entry = profile.entries[i] ; 
+		switch ( entry.type )
+		{
+			case IISU_PARAMETER_BOOL : count( getBool( entry.path ).set( entry.boolValue ) , entry.path ) ; break ; 
+			case IISU_PARAMETER_INT : count( getInt( entry.path ).set( entry.intValue ) , entry.path ) ; break ; 
+			case IISU_PARAMETER_FLOAT : count( getFloat( entry.path ).set( entry.floatValue ) , entry.path ) ; break ; 
+		}
+	}
+
+	lastApply.micros = ofGetElapsedTimeMicros() - start ; 
+	return ( lastApply.numFailed == 0 ) ; 
+}
+
+void IisuParameters::count( IisuParameterResult result , const string &path )
+{
+	switch ( result )
+	{
+		case IISU_PARAMETER_SET : lastApply.numSet++ ; break ; 
+		case IISU_PARAMETER_UNCHANGED : lastApply.numUnchanged++ ; break ; 
+		case IISU_PARAMETER_FAILED :
+			lastApply.numFailed++ ; 
+			cout << "IisuParameters::apply :: couldn't set " << path << endl ; 
+			break ; 
+	}
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+/*
+	IisuParameters
+	iisu parameters ( SHAPE.CENTROIDS.Count , CI.Enabled ... ) read once and kept. get() never goes to iisu , the
+	cache only moves when the value is set through it or on refresh() , so per frame reads cost a member access.
+	Profiles are named lists of values applied in one go , values iisu already has are skipped and every
+	apply() is timed. "default" , "close-range" , "crowd" and "low-power" are there from the start.
+*/
+
+#include <SDK/iisuSDK.h>
+#include "ofMain.h"
+
+enum IisuParameterResult
+{
+	IISU_PARAMETER_UNCHANGED = 0 ,		//the cache already had it , iisu wasn't asked
+	IISU_PARAMETER_SET ,
+	IISU_PARAMETER_FAILED				//no device , unknown path or iisu said no , the cache keeps the old value
+}; 
+
+template<typename T>
+class IisuParameter
+{
+	public :
+		IisuParameter( )
+		{
+			value = T() ; 
+			bCached = false ; 
+		}
+
+		//Registers the handle and reads the value once , a NULL device ( replay ) leaves it unregistered
+		void setup( SK::Device * device , const string &_path )
+		{
+			path = _path ; 
+			bCached = false ; 
+			handle = ( device != NULL ) ? device->registerParameterHandle<T>( path.c_str() ) : SK::ParameterHandle<T>() ; 
+			refresh( ) ; 
+		}
+
+		//Last value read or set. Plain copy , fine to read from iisu's frame thread
+		T get( ) const { return value ; }
+		bool isCached( ) const { return bCached ; }
+		const string& getPath( ) const { return path ; }
+
+		IisuParameterResult set( const T &_value )
+		{
+			if ( bCached && value == _value )
+				return IISU_PARAMETER_UNCHANGED ; 
+			if ( handle.isValid() == false || handle.set( _value ).failed() )
+				return IISU_PARAMETER_FAILED ; 
+			value = _value ; 
+			bCached = true ; 
+			return IISU_PARAMETER_SET ; 
+		}
+
+		//Asks iisu again , for values changed behind our back ( iisu's own tools , another client )
+		bool refresh( )
+		{
+			if ( handle.isValid() == false )
+				return false ; 
+			value = handle.get() ; 
+			bCached = true ; 
+			return true ; 
+		}
+
+	protected :
+		SK::ParameterHandle<T> handle ; 
+		string path ; 
+		T value ; 
+		bool bCached ; 
+}; 
+
+enum IisuParameterType
+{
+	IISU_PARAMETER_BOOL = 0 ,
+	IISU_PARAMETER_INT ,
+	IISU_PARAMETER_FLOAT
+}; 
+
+struct IisuParameterEntry
+{
+	string path ; 
+	IisuParameterType type ; 
+	bool boolValue ; 
+	int32_t intValue ; 
+	float floatValue ; 
+}; 
+
+//set() picks the type from the value , write floats as 0.5f
+class IisuParameterProfile
+{
+	public :
+		IisuParameterProfile( const string &_name = "" ) { name = _name ; }
+
+		IisuParameterProfile& set( const string &path , bool value ) ; 
+		IisuParameterProfile& set( const string &path , int32_t value ) ; 
+		IisuParameterProfile& set( const string &path , float value ) ; 
+
+		string name ; 
+		vector<IisuParameterEntry> entries ; 
+
+	protected :
+		IisuParameterEntry& entry( const string &path , IisuParameterType type ) ; 
+}; 
+
+struct IisuParameterApplyStats
+{
+	IisuParameterApplyStats( )
+	{
+		numSet = 0 ; 
+		numUnchanged = 0 ; 
+		numFailed = 0 ; 
+		micros = 0 ; 
+	}
+
+	string profile ; 
+	int numSet ; 
+	int numUnchanged ; 
+	int numFailed ; 
+	unsigned long long micros ;			//the whole apply() , registering new handles included
+}; 
+
+class IisuParameters
+{
+	public :
+		IisuParameters( ) ; 
+
+		//Registers every parameter asked for so far with the device and reads them , IisuServer calls it from initIisu()
+		void setup( SK::Device * _device ) ; 
+		//Everything again from iisu
+		void refresh( ) ; 
+
+		//The cached parameter for path , registered the first time it's asked for. References stay good
+		IisuParameter<bool>& getBool( const string &path ) ; 
+		IisuParameter<int32_t>& getInt( const string &path ) ; 
+		IisuParameter<float>& getFloat( const string &path ) ; 
+
+		//A profile with the same name is replaced
+		void addProfile( const IisuParameterProfile &profile ) ; 
+		IisuParameterProfile * getProfile( const string &name ) ; 
+		vector<IisuParameterProfile> profiles ; 
+
+		//App thread , at startup or any time after. false if the profile is unknown or a value didn't make it
+		bool apply( const string &name ) ; 
+		bool apply( const IisuParameterProfile &profile ) ; 
+		const IisuParameterApplyStats& getLastApply( ) const { return lastApply ; }
+
+	protected :
+		template<typename T>
+		IisuParameter<T>& find( map< string , IisuParameter<T> > &parameters , const string &path )
+		{
+			typename map< string , IisuParameter<T> >::iterator it = parameters.find( path ) ; 
+			if ( it != parameters.end() )
+				return it->second ; 
+			IisuParameter<T> &parameter = parameters[ path ] ; 
+			parameter.setup( device , path ) ; 
+			return parameter ; 
+		}
+
+		void count( IisuParameterResult result , const string &path ) ; 
+		void addDefaultProfiles( ) ; 
+
+		SK::Device * device ; 
+		map< string , IisuParameter<bool> > bools ; 
+		map< string , IisuParameter<int32_t> > ints ; 
+		map< string , IisuParameter<float> > floats ; 
+		IisuParameterApplyStats lastApply ; 
+}; 
@@ -0,0 +1,136 @@
+#include "IisuProfiler.h"
+#include <algorithm>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+bool IisuProfiler::bEnabled = false ; 
+
+IisuProfiler::IisuProfiler( ) 
+{
+	reset( ) ; 
+	sorted.reserve( IISU_PROFILE_SAMPLES ) ; 
+}
+
+unsigned long long IisuProfiler::now( ) 
+{
+#ifdef WIN32
+	static LARGE_INTEGER frequency = { 0 } ; 
+	if ( frequency.QuadPart == 0 ) 
+		QueryPerformanceFrequency( &frequency ) ; 
+	LARGE_INTEGER counter ; 
+	QueryPerformanceCounter( &counter ) ; 
+	//Whole seconds and the rest apart , counter * 1000000 overflows after days of uptime
+	unsigned long long ticks = (unsigned long long) counter.QuadPart ; 
+	unsigned long long perSecond = (unsigned long long) frequency.QuadPart ; 
+	return ( ticks / perSecond ) * 1000000 + ( ticks % perSecond ) * 1000000 / perSecond ; 
+#else
+	//Monotonic , a wall clock adjustment mid frame would show up as a huge or negative stage
+	struct timespec ts ; 
+	clock_gettime( CLOCK_MONOTONIC , &ts ) ; 
+	return (unsigned long long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000 ; 
+#endif
+}
+
+void IisuProfiler::addSample( IisuProfileStage stage , float micros ) 
+{
+	unsigned int n = numWritten[ stage ] ; 
+	samples[ n % IISU_PROFILE_SAMPLES ][ stage ] = micros ; 
+	numWritten[ stage ] = n + 1 ; 
+}
+
+void IisuProfiler::markLatched( const IisuFrame &frame ) 
+{
+	if ( bEnabled && frame.deliveredMicros != 0 ) 
+		addSample( IISU_STAGE_DELIVERY_TO_LATCH , (float) ( now( ) - frame.deliveredMicros ) ) ; 
+}
+
+void IisuProfiler::markDrawn( const IisuFrame &frame ) 
+{
+	//A frame drawn twice only counts the first time
+	if ( bEnabled == false || frame.deliveredMicros == 0 || frame.frameID == lastDrawnFrameID ) 
+		return ; 
+
+	lastDrawnFrameID = frame.frameID ; 
+	addSample( IISU_STAGE_DELIVERY_TO_DRAW , (float) ( now( ) - frame.deliveredMicros ) ) ; 
+}
+
+void IisuProfiler::reset( ) 
+{
+	for ( int i = 0 ; i < IISU_STAGE_COUNT ; i++ ) 
+		numWritten[i] = 0 ; 
+	lastDrawnFrameID = -1 ; 
+}
+
+IisuProfileStats IisuProfiler::getStats( IisuProfileStage stage ) 
+{
+	IisuProfileStats stats ; 
+	int count = MIN( numWritten[ stage ] , IISU_PROFILE_SAMPLES ) ; 
+	if ( count == 0 ) 
+		return stats ; 
+
+	sorted.resize( count ) ; 
+	double total = 0.0 ; 
+	for ( int i = 0 ; i < count ; i++ ) 
+	{
+		sorted[i] = samples[i][ stage ] ; 
+		total += sorted[i] ; 
+	}
+	std::sort( sorted.begin() , sorted.end() ) ; 
+
+	stats.numSamples = count ; 
+	stats.mean = (float) ( total / count ) ; 
+	stats.p50 = sorted[ ( count - 1 ) * 50 / 100 ] ; 
+	stats.p95 = sorted[ ( count - 1 ) * 95 / 100 ] ; 
+	stats.p99 = sorted[ ( count - 1 ) * 99 / 100 ] ; 
+	stats.max = sorted[ count - 1 ] ; 
+	return stats ; 
+}
+
+const char * IisuProfiler::getStageName( IisuProfileStage stage ) 
+{
+	switch ( stage ) 
+	{
+		case IISU_STAGE_DATA_FRAME : return "DataFrame / acquire" ; 
+		case IISU_STAGE_UPDATE_FRAME : return "  updateFrame" ; 
+		case IISU_STAGE_GET_USERS : return "  get users" ; 
+		case IISU_STAGE_GET_LABEL_IMAGE : return "  get label image" ; 
+		case IISU_STAGE_GET_CONTROLLERS : return "  get controllers" ; 
+		case IISU_STAGE_GET_HANDS : return "  get hands" ; 
+		case IISU_STAGE_GET_SHAPE : return "  get shape" ; 
+		case IISU_STAGE_RELEASE_FRAME : return "  releaseFrame" ; 
+		case IISU_STAGE_PUBLISH : return "  publish" ; 
+		case IISU_STAGE_SERVER_UPDATE : return "IisuServer::update" ; 
+		case IISU_STAGE_SKELETON_UPDATE : return "IisuSkeleton::update" ; 
+		case IISU_STAGE_USER_REP_UPDATE : return "IisuUserRepresentation::update" ; 
+		case IISU_STAGE_CURSOR_UPDATE : return "cursor update" ; 
+		case IISU_STAGE_DRAW : return "draw" ; 
+		case IISU_STAGE_DELIVERY_TO_LATCH : return "delivery -> latch" ; 
+		case IISU_STAGE_DELIVERY_TO_DRAW : return "delivery -> draw" ; 
+		case IISU_STAGE_FRAME_INTERVAL : return "frame interval" ; 
+		default : return "" ; 
+	}
+}
+
+void IisuProfiler::draw( float x , float y ) 
+{
+	string text = bEnabled ? "iisu latency ( us )  p50 / p95 / p99 / max\n" : "iisu latency : profiler disabled\n" ; 
+	for ( int i = 0 ; i < IISU_STAGE_COUNT ; i++ ) 
+	{
+		IisuProfileStage stage = (IisuProfileStage) i ; 
+		IisuProfileStats stats = getStats( stage ) ; 
+		if ( stats.numSamples == 0 ) 
+			continue ; 
+
+		text += string( getStageName( stage ) ) + " : " + ofToString( stats.p50 , 0 ) + " / " + ofToString( stats.p95 , 0 ) + 
+				" / " + ofToString( stats.p99 , 0 ) + " / " + ofToString( stats.max , 0 ) + "\n" ; 
+	}
+
+	ofPushStyle( ) ; 
+		ofSetColor( 255 , 255 , 255 ) ; 
+		ofDrawBitmapStringHighlight( text , x , y ) ; 
+	ofPopStyle( ) ; 
+}
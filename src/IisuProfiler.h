@@ -0,0 +1,125 @@
+#pragma once
+
+/*
+	IisuProfiler
+	Where a frame's time goes , from iisu's DEVICE.DataFrame event to our draw().
+	Every stage keeps its last IISU_PROFILE_SAMPLES timings in a ring buffer , stats are rolling percentiles.
+	Wrap a stage in IISU_PROFILE_SCOPE( stage ). Disabled ( the default ) that costs one bool check ,
+	defining IISU_NO_PROFILING compiles the timers out completely.
+
+		IisuProfiler::Instance()->setEnabled( true ) ; 
+		...
+		IisuProfiler::Instance()->markDrawn( iisuServer->getFrame() ) ;	//end of testApp::draw()
+		IisuProfiler::Instance()->draw( 10 , 20 ) ;
+*/
+
+#include "ofMain.h"
+#include "IisuFrame.h"
+
+#define IISU_PROFILE_SAMPLES 512
+
+enum IisuProfileStage
+{
+	//iisu's thread
+	IISU_STAGE_DATA_FRAME = 0 ,			//whole DEVICE.DataFrame handler , or the acquisition thread's work per frame
+	IISU_STAGE_UPDATE_FRAME ,			//Device::updateFrame
+	IISU_STAGE_GET_USERS ,				//handle get()s , grouped by what they read
+	IISU_STAGE_GET_LABEL_IMAGE ,
+	IISU_STAGE_GET_CONTROLLERS ,
+	IISU_STAGE_GET_HANDS ,
+	IISU_STAGE_GET_SHAPE ,
+	IISU_STAGE_RELEASE_FRAME ,
+	IISU_STAGE_PUBLISH ,				//recording + triple buffer hand off
+
+	//App thread
+	IISU_STAGE_SERVER_UPDATE ,			//IisuServer::update , latch + processFrame
+	IISU_STAGE_SKELETON_UPDATE ,
+	IISU_STAGE_USER_REP_UPDATE ,
+	IISU_STAGE_CURSOR_UPDATE ,
+	IISU_STAGE_DRAW ,
+
+	//Age of the frame , measured from the start of its DEVICE.DataFrame handler
+	IISU_STAGE_DELIVERY_TO_LATCH ,		//until IisuServer::update picked it up
+	IISU_STAGE_DELIVERY_TO_DRAW ,		//until markDrawn
+
+	IISU_STAGE_FRAME_INTERVAL ,			//between two new frames , IISU_ACQUIRE_THREAD only
+
+	IISU_STAGE_COUNT
+};
+
+struct IisuProfileStats
+{
+	IisuProfileStats( ) 
+	{
+		numSamples = 0 ; 
+		mean = p50 = p95 = p99 = max = 0.0f ; 
+	}
+
+	int numSamples ; 
+	float mean , p50 , p95 , p99 , max ;		//microseconds
+};
+
+class IisuProfiler
+{
+	public :
+		IisuProfiler( ) ; 
+
+		static IisuProfiler* Instance()
+		{
+			static IisuProfiler inst;
+			return &inst;
+		}
+
+		static bool bEnabled ; 
+		void setEnabled( bool _bEnabled ) { bEnabled = _bEnabled ; } 
+		bool isEnabled( ) { return bEnabled ; } 
+
+		//Microseconds from a high resolution clock , only differences mean anything
+		static unsigned long long now( ) ; 
+
+		//Each stage has to be written from one thread only
+		void addSample( IisuProfileStage stage , float micros ) ; 
+		void markLatched( const IisuFrame &frame ) ; 
+		void markDrawn( const IisuFrame &frame ) ; 
+		void reset( ) ; 
+
+		IisuProfileStats getStats( IisuProfileStage stage ) ; 
+		static const char * getStageName( IisuProfileStage stage ) ; 
+
+		//One line per stage that has samples
+		void draw( float x , float y ) ; 
+
+	protected :
+		float samples[ IISU_PROFILE_SAMPLES ][ IISU_STAGE_COUNT ] ; 
+		unsigned int numWritten[ IISU_STAGE_COUNT ] ; 
+		int lastDrawnFrameID ; 
+		vector<float> sorted ;						//scratch for the percentiles
+};
+
+class IisuScopedTimer
+{
+	public :
+		IisuScopedTimer( IisuProfileStage _stage ) 
+		{
+			stage = _stage ; 
+			start = IisuProfiler::bEnabled ? IisuProfiler::now( ) : 0 ; 
+		}
+
+		~IisuScopedTimer( ) 
+		{
+			if ( start != 0 ) 
+				IisuProfiler::Instance()->addSample( stage , (float) ( IisuProfiler::now( ) - start ) ) ; 
+		}
+
+	protected :
+		IisuProfileStage stage ; 
+		unsigned long long start ; 
+};
+
+#ifdef IISU_NO_PROFILING
+#define IISU_PROFILE_SCOPE( stage )
+#else
+#define IISU_PROFILE_CONCAT2( a , b ) a##b
+#define IISU_PROFILE_CONCAT( a , b ) IISU_PROFILE_CONCAT2( a , b )
+#define IISU_PROFILE_SCOPE( stage ) IisuScopedTimer IISU_PROFILE_CONCAT( iisuScopedTimer , __LINE__ )( stage )
+#endif
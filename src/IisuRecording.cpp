@@ -0,0 +1,875 @@
+#include "IisuRecording.h"
+#include <algorithm>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//Encoding helpers , everything is written byte by byte in little endian order
+
+static void writeBytes( vector<unsigned char> &out , const void * bytes , size_t length )
+{
+	const unsigned char * p = (const unsigned char *) bytes ;
+	out.insert( out.end() , p , p + length ) ;
+}
+
+static void writeUInt32( vector<unsigned char> &out , uint32_t value )
+{
+	unsigned char bytes[4] = { value & 0xFF , ( value >> 8 ) & 0xFF , ( value >> 16 ) & 0xFF , ( value >> 24 ) & 0xFF } ;
+	writeBytes( out , bytes , 4 ) ;
+}
+
+static void writeUInt16( vector<unsigned char> &out , uint16_t value )
+{
+	unsigned char bytes[2] = { value & 0xFF , ( value >> 8 ) & 0xFF } ;
+	writeBytes( out , bytes , 2 ) ;
+}
+
+static void writeInt32( vector<unsigned char> &out , int32_t value )
+{
+	writeUInt32( out , (uint32_t) value ) ;
+}
+
+static void writeFloat( vector<unsigned char> &out , float value )
+{
+	uint32_t bits ;
+	memcpy( &bits , &value , 4 ) ;
+	writeUInt32( out , bits ) ;
+}
+
+static void writeDouble( vector<unsigned char> &out , double value )
+{
+	uint32_t bits[2] ;
+	memcpy( bits , &value , 8 ) ;
+	writeUInt32( out , bits[0] ) ;
+	writeUInt32( out , bits[1] ) ;
+}
+
+static void writeVector3( vector<unsigned char> &out , const Vector3 &v )
+{
+	writeFloat( out , v.x ) ;
+	writeFloat( out , v.y ) ;
+	writeFloat( out , v.z ) ;
+}
+
+static void writeVector2( vector<unsigned char> &out , const Vector2 &v )
+{
+	writeFloat( out , v.x ) ;
+	writeFloat( out , v.y ) ;
+}
+
+//Writes the field header with an empty length , endField patches it once the data is in
+static size_t beginField( vector<unsigned char> &out , IisuRecordingField field , int entity = 0 )
+{
+	writeUInt16( out , (uint16_t) field ) ;
+	writeUInt16( out , (uint16_t) entity ) ;
+	writeUInt32( out , 0 ) ;
+	return out.size() ;
+}
+
+static void endField( vector<unsigned char> &out , size_t start )
+{
+	uint32_t length = out.size() - start ;
+	out[ start - 4 ] = length & 0xFF ;
+	out[ start - 3 ] = ( length >> 8 ) & 0xFF ;
+	out[ start - 2 ] = ( length >> 16 ) & 0xFF ;
+	out[ start - 1 ] = ( length >> 24 ) & 0xFF ;
+}
+
+//( run length , value ) pairs , label images are mostly long runs of the same few values
+static void encodeRuns( const unsigned char * data , size_t size , vector<unsigned char> &out )
+{
+	size_t i = 0 ;
+	while ( i < size )
+	{
+		unsigned char value = data[i] ;
+		size_t run = 1 ;
+		while ( i + run < size && run < 255 && data[ i + run ] == value )
+			run++ ;
+
+		out.push_back( (unsigned char) run ) ;
+		out.push_back( value ) ;
+		i += run ;
+	}
+}
+
+//Decoding , every read is bounds checked so a truncated or corrupt chunk just fails
+struct IisuByteReader
+{
+	IisuByteReader( const unsigned char * _p , size_t length )
+	{
+		p = _p ;
+		end = _p + length ;
+		bOk = true ;
+	}
+
+	bool has( size_t length )
+	{
+		if ( bOk && (size_t) ( end - p ) >= length )
+			return true ;
+		bOk = false ;
+		return false ;
+	}
+
+	uint32_t readUInt32( )
+	{
+		if ( !has( 4 ) ) return 0 ;
+		uint32_t value = p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( (uint32_t) p[3] << 24 ) ;
+		p += 4 ;
+		return value ;
+	}
+
+	unsigned char readUInt8( )
+	{
+		if ( !has( 1 ) ) return 0 ;
+		return *p++ ;
+	}
+
+	uint16_t readUInt16( )
+	{
+		if ( !has( 2 ) ) return 0 ;
+		uint16_t value = p[0] | ( p[1] << 8 ) ;
+		p += 2 ;
+		return value ;
+	}
+
+	int32_t readInt32( ) { return (int32_t) readUInt32( ) ; }
+
+	float readFloat( )
+	{
+		uint32_t bits = readUInt32( ) ;
+		float value ;
+		memcpy( &value , &bits , 4 ) ;
+		return value ;
+	}
+
+	double readDouble( )
+	{
+		uint32_t bits[2] ;
+		bits[0] = readUInt32( ) ;
+		bits[1] = readUInt32( ) ;
+		double value ;
+		memcpy( &value , bits , 8 ) ;
+		return value ;
+	}
+
+	Vector3 readVector3( )
+	{
+		float x = readFloat( ) ;
+		float y = readFloat( ) ;
+		float z = readFloat( ) ;
+		return Vector3( x , y , z ) ;
+	}
+
+	Vector2 readVector2( )
+	{
+		float x = readFloat( ) ;
+		float y = readFloat( ) ;
+		return Vector2( x , y ) ;
+	}
+
+	const unsigned char * p ;
+	const unsigned char * end ;
+	bool bOk ;
+};
+
+static bool decodeRuns( IisuByteReader &reader , size_t length , unsigned char * out , size_t size )
+{
+	if ( !reader.has( length ) || ( length % 2 ) != 0 )
+		return false ;
+
+	size_t written = 0 ;
+	for ( size_t i = 0 ; i < length ; i += 2 )
+	{
+		size_t run = reader.p[ i ] ;
+		if ( written + run > size )
+			return false ;
+		memset( out + written , reader.p[ i + 1 ] , run ) ;
+		written += run ;
+	}
+	reader.p += length ;
+	return ( written == size ) ;
+}
+
+//------------------------------------------------------------------ IisuRecorder
+
+IisuRecorder::IisuRecorder( )
+{
+	file = NULL ;
+	bRecording = 0 ;
+	numInFlight = 0 ;
+	bResetEncoder = 0 ;
+	keyframeInterval = 60 ;
+	maxPendingChunks = 600 ;
+	framesSinceKeyframe = 0 ;
+	numFrames = 0 ;
+	numDroppedFrames = 0 ;
+	bytesWritten = 0 ;
+	chunkCapacity = 0 ;
+	maxLabelPixels = 0 ;
+}
+
+IisuRecorder::~IisuRecorder( )
+{
+	close( ) ;
+}
+
+void IisuRecorder::reserve( const IisuFrame &sizes )
+{
+	chunkCapacity = getMaxChunkSize( sizes ) ;
+	maxLabelPixels = sizes.labelImage.capacity() ;
+}
+
+size_t IisuRecorder::getMaxChunkSize( const IisuFrame &sizes )
+{
+	//Same fields as encodeFrame , every one at its biggest
+	size_t field = 8 ;
+	size_t bytes = 8 + 4 + 8 ;
+	bytes += field + 1 + field + 4 + field + 12 + field + 4 ;
+	bytes += 2 * field + sizes.keyPoints.capacity() * ( 12 + 4 ) ;
+	bytes += field + 4 + 2 * field + sizes.centroidPositions.capacity() * ( 12 + 4 ) ;
+	bytes += field + 4 + sizes.labelImage.capacity() * 2 ;			//runs of one pixel , the worst the encoding gets
+	bytes += IISU_MAX_CONTROLLERS * ( field + 1 + 4 + 24 ) ;
+	bytes += IISU_MAX_HANDS * ( field + 33 + 5 * 12 ) ;				//five fingers
+	bytes += sizes.getNumUserSlots() * ( field + 20 + IISU_NUM_JOINTS * 16 ) ;
+	return bytes ;
+}
+
+bool IisuRecorder::open( string path )
+{
+	close( ) ;
+
+	file = fopen( ofToDataPath( path ).c_str() , "wb" ) ;
+	if ( file == NULL )
+	{
+		ofLog( OF_LOG_ERROR , "IisuRecorder::open :: could not open " + path ) ;
+		return false ;
+	}
+
+	//Every chunk up front. Neither thread is running ( close() waited for them ) so the queues can be refilled from here
+	int numChunks = MAX( 1 , MIN( maxPendingChunks , IISU_RECORDER_MAX_CHUNKS ) ) ;
+	chunkPool.resize( numChunks ) ;
+	int chunk ;
+	while ( freeChunks.pop( chunk ) ) ;
+	while ( filledChunks.pop( chunk ) ) ;
+	for ( int i = 0 ; i < numChunks ; i++ )
+	{
+		chunkPool[i].clear() ;
+		chunkPool[i].reserve( chunkCapacity ) ;
+		freeChunks.push( i ) ;
+	}
+	previousLabel.reserve( maxLabelPixels ) ;
+	labelDelta.reserve( maxLabelPixels ) ;
+
+	unsigned char version = IISU_RECORDING_VERSION ;
+	fwrite( IISU_RECORDING_MAGIC , 1 , 7 , file ) ;
+	fwrite( &version , 1 , 1 , file ) ;
+	bytesWritten = 8 ;
+
+	//No addFrame is running ( close() waited for it ) , the encoder itself is reset on iisu's thread
+	iisuAtomicStore( &numFrames , 0 ) ;
+	iisuAtomicStore( &numDroppedFrames , 0 ) ;
+	iisuAtomicStore( &bResetEncoder , 1 ) ;
+
+	startThread( true , false ) ;
+	iisuAtomicStore( &bRecording , 1 ) ;
+	return true ;
+}
+
+void IisuRecorder::close( )
+{
+	if ( file == NULL )
+		return ;
+
+	//Stop new frames first , then wait for the one iisu's thread may be encoding right now
+	iisuAtomicStore( &bRecording , 0 ) ;
+	while ( iisuAtomicLoad( &numInFlight ) > 0 )
+		ofSleepMillis( 0 ) ;
+
+	waitForThread( true ) ;
+
+	//Whatever the thread didn't get to
+	writePending( ) ;
+
+	fclose( file ) ;
+	file = NULL ;
+}
+
+void IisuRecorder::addFrame( const IisuFrame &frame )
+{
+	//Counted before the flag is checked , so close() either sees us in flight or we see it stopped
+	iisuAtomicAdd( &numInFlight , 1 ) ;
+	if ( iisuAtomicLoad( &bRecording ) == 0 )
+	{
+		iisuAtomicAdd( &numInFlight , -1 ) ;
+		return ;
+	}
+
+	if ( iisuAtomicExchange( &bResetEncoder , 0 ) != 0 )
+	{
+		previousLabel.clear() ;
+		framesSinceKeyframe = 0 ;
+	}
+
+	//No free chunk means the disk is maxPendingChunks behind
+	int chunk ;
+	if ( freeChunks.pop( chunk ) == false )
+	{
+		iisuAtomicAdd( &numDroppedFrames , 1 ) ;
+		iisuAtomicAdd( &numInFlight , -1 ) ;
+		return ;
+	}
+
+	chunkPool[ chunk ].clear() ;
+	encodeFrame( frame , chunkPool[ chunk ] ) ;
+	filledChunks.push( chunk ) ;
+	iisuAtomicAdd( &numFrames , 1 ) ;
+	iisuAtomicAdd( &numInFlight , -1 ) ;
+}
+
+void IisuRecorder::threadedFunction( )
+{
+	while ( isThreadRunning() )
+	{
+		writePending( ) ;
+		ofSleepMillis( 5 ) ;
+	}
+}
+
+void IisuRecorder::writePending( )
+{
+	//The recorder's thread , or close() once it has stopped
+	int chunk ;
+	bool bWrote = false ;
+	while ( filledChunks.pop( chunk ) )
+	{
+		vector<unsigned char> &bytes = chunkPool[ chunk ] ;
+		fwrite( &bytes[0] , 1 , bytes.size() , file ) ;
+		bytesWritten += bytes.size() ;
+		freeChunks.push( chunk ) ;
+		bWrote = true ;
+	}
+	if ( bWrote )
+		fflush( file ) ;
+}
+
+void IisuRecorder::encodeFrame( const IisuFrame &frame , vector<unsigned char> &chunk )
+{
+	bool bKeyframe = true ;
+
+	//Chunk header , type and length are patched in at the end
+	writeUInt32( chunk , 0 ) ;
+	writeUInt32( chunk , 0 ) ;
+	size_t chunkStart = chunk.size() ;
+
+	writeInt32( chunk , frame.frameID ) ;
+	writeDouble( chunk , frame.timestamp ) ;
+
+	size_t field = beginField( chunk , IISU_FIELD_USER_IS_ACTIVE ) ;
+	chunk.push_back( frame.userIsActive ? 1 : 0 ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_USER1_SCENE_ID ) ;
+	writeInt32( chunk , frame.user1SceneID ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_USER1_MASS_CENTER ) ;
+	writeVector3( chunk , frame.user1MassCenter ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_SKELETON_STATUS ) ;
+	writeInt32( chunk , frame.skeletonStatus ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_KEY_POINTS ) ;
+	for ( int i = 0 ; i < frame.keyPoints.size() ; i++ )
+		writeVector3( chunk , frame.keyPoints[i] ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_KEY_POINTS_CONFIDENCE ) ;
+	for ( int i = 0 ; i < frame.keyPointsConfidence.size() ; i++ )
+		writeFloat( chunk , frame.keyPointsConfidence[i] ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_CENTROID_COUNT ) ;
+	writeInt32( chunk , frame.centroidCount ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_CENTROID_POSITIONS ) ;
+	for ( int i = 0 ; i < frame.centroidPositions.size() ; i++ )
+		writeVector3( chunk , frame.centroidPositions[i] ) ;
+	endField( chunk , field ) ;
+
+	field = beginField( chunk , IISU_FIELD_CENTROID_JUMP_STATUS ) ;
+	for ( int i = 0 ; i < frame.centroidJumpStatus.size() ; i++ )
+		writeInt32( chunk , frame.centroidJumpStatus[i] ) ;
+	endField( chunk , field ) ;
+
+	size_t labelSize = frame.labelImage.size() ;
+	if ( labelSize > 0 )
+	{
+		bool bLabelKeyframe = ( framesSinceKeyframe == 0 || previousLabel.size() != labelSize ) ;
+		field = beginField( chunk , bLabelKeyframe ? IISU_FIELD_LABEL_KEYFRAME : IISU_FIELD_LABEL_DELTA ) ;
+		writeUInt16( chunk , (uint16_t) frame.labelWidth ) ;
+		writeUInt16( chunk , (uint16_t) frame.labelHeight ) ;
+		if ( bLabelKeyframe )
+		{
+			encodeRuns( &frame.labelImage[0] , labelSize , chunk ) ;
+		}
+		else
+		{
+			labelDelta.resize( labelSize ) ;
+			for ( size_t i = 0 ; i < labelSize ; i++ )
+				labelDelta[i] = frame.labelImage[i] ^ previousLabel[i] ;
+			encodeRuns( &labelDelta[0] , labelSize , chunk ) ;
+			bKeyframe = false ;
+		}
+		endField( chunk , field ) ;
+
+		previousLabel.assign( frame.labelImage.begin() , frame.labelImage.end() ) ;
+		framesSinceKeyframe = ( framesSinceKeyframe + 1 ) % MAX( keyframeInterval , 1 ) ;
+	}
+	else
+	{
+		//Start over with a keyframe once the image comes back
+		previousLabel.clear() ;
+		framesSinceKeyframe = 0 ;
+	}
+
+	for ( int i = 0 ; i < frame.controllers.size() ; i++ )
+	{
+		const IisuControllerFrame &controller = frame.controllers[i] ;
+		field = beginField( chunk , IISU_FIELD_CONTROLLER , i ) ;
+		chunk.push_back( controller.isActive ? 1 : 0 ) ;
+		writeInt32( chunk , controller.status ) ;
+		writeVector3( chunk , controller.normalizedCoordinates ) ;
+		writeVector3( chunk , controller.worldCoordinates ) ;
+		endField( chunk , field ) ;
+	}
+
+	for ( int i = 0 ; i < frame.hands.size() ; i++ )
+	{
+		const IisuHandFrame &hand = frame.hands[i] ;
+		field = beginField( chunk , IISU_FIELD_HAND , i ) ;
+		writeInt32( chunk , hand.status ) ;
+		writeVector2( chunk , hand.palmPosition2D ) ;
+		writeVector2( chunk , hand.tipPosition2D ) ;
+		chunk.push_back( hand.isOpen ? 1 : 0 ) ;
+		writeFloat( chunk , hand.openAmount ) ;
+		writeUInt32( chunk , hand.fingerTipsStatus.size() ) ;
+		for ( int f = 0 ; f < hand.fingerTipsStatus.size() ; f++ )
+			writeInt32( chunk , hand.fingerTipsStatus[f] ) ;
+		writeUInt32( chunk , hand.fingerTips2D.size() ) ;
+		for ( int f = 0 ; f < hand.fingerTips2D.size() ; f++ )
+			writeVector2( chunk , hand.fingerTips2D[f] ) ;
+		endField( chunk , field ) ;
+	}
+
+	for ( int i = 0 ; i < frame.activeUsers.size() ; i++ )
+	{
+		int user = frame.activeUsers[i] ;
+		if ( user == 0 )
+			continue ;
+
+		field = beginField( chunk , IISU_FIELD_USER , user ) ;
+		writeInt32( chunk , frame.userSceneIDs[ user ] ) ;
+		writeInt32( chunk , frame.userSkeletonStatus[ user ] ) ;
+		writeVector3( chunk , frame.userMassCenters[ user ] ) ;
+		const Vector3 * keyPoints = frame.getUserKeyPoints( user ) ;
+		const float * confidence = frame.getUserKeyPointsConfidence( user ) ;
+		for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ )
+			writeVector3( chunk , keyPoints[j] ) ;
+		for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ )
+			writeFloat( chunk , confidence[j] ) ;
+		endField( chunk , field ) ;
+	}
+
+	//Patch the chunk header
+	uint32_t type = bKeyframe ? IISU_CHUNK_KEYFRAME : IISU_CHUNK_DELTA ;
+	uint32_t length = chunk.size() - chunkStart ;
+	for ( int b = 0 ; b < 4 ; b++ )
+	{
+		chunk[ chunkStart - 8 + b ] = ( type >> ( b * 8 ) ) & 0xFF ;
+		chunk[ chunkStart - 4 + b ] = ( length >> ( b * 8 ) ) & 0xFF ;
+	}
+}
+
+//------------------------------------------------------------------ IisuMappedFile
+
+IisuMappedFile::IisuMappedFile( )
+{
+	data = NULL ;
+	size = 0 ;
+#ifdef WIN32
+	fileHandle = INVALID_HANDLE_VALUE ;
+	mappingHandle = NULL ;
+#else
+	fileDescriptor = -1 ;
+#endif
+}
+
+bool IisuMappedFile::open( string path )
+{
+	close( ) ;
+	string fullPath = ofToDataPath( path ) ;
+
+#ifdef WIN32
+	fileHandle = CreateFileA( fullPath.c_str() , GENERIC_READ , FILE_SHARE_READ , NULL , OPEN_EXISTING , FILE_ATTRIBUTE_NORMAL , NULL ) ;
+	if ( fileHandle == INVALID_HANDLE_VALUE )
+		return false ;
+
+	LARGE_INTEGER fileSize ;
+	GetFileSizeEx( fileHandle , &fileSize ) ;
+	size = (size_t) fileSize.QuadPart ;
+
+	if ( size > 0 )
+	{
+		mappingHandle = CreateFileMappingA( fileHandle , NULL , PAGE_READONLY , 0 , 0 , NULL ) ;
+		if ( mappingHandle != NULL )
+			data = (const unsigned char *) MapViewOfFile( mappingHandle , FILE_MAP_READ , 0 , 0 , 0 ) ;
+	}
+#else
+	fileDescriptor = ::open( fullPath.c_str() , O_RDONLY ) ;
+	if ( fileDescriptor < 0 )
+		return false ;
+
+	struct stat fileInfo ;
+	fstat( fileDescriptor , &fileInfo ) ;
+	size = fileInfo.st_size ;
+
+	if ( size > 0 )
+	{
+		void * mapped = mmap( NULL , size , PROT_READ , MAP_PRIVATE , fileDescriptor , 0 ) ;
+		if ( mapped != MAP_FAILED )
+			data = (const unsigned char *) mapped ;
+	}
+#endif
+
+	if ( data == NULL )
+	{
+		close( ) ;
+		return false ;
+	}
+	return true ;
+}
+
+void IisuMappedFile::close( )
+{
+#ifdef WIN32
+	if ( data != NULL )
+		UnmapViewOfFile( data ) ;
+	if ( mappingHandle != NULL )
+		CloseHandle( mappingHandle ) ;
+	if ( fileHandle != INVALID_HANDLE_VALUE )
+		CloseHandle( fileHandle ) ;
+	mappingHandle = NULL ;
+	fileHandle = INVALID_HANDLE_VALUE ;
+#else
+	if ( data != NULL )
+		munmap( (void *) data , size ) ;
+	if ( fileDescriptor >= 0 )
+		::close( fileDescriptor ) ;
+	fileDescriptor = -1 ;
+#endif
+	data = NULL ;
+	size = 0 ;
+}
+
+//------------------------------------------------------------------ IisuRecordingFrameSource
+
+bool IisuRecordingFrameSource::open( )
+{
+	close( ) ;
+
+	if ( file.open( path ) == false )
+	{
+		ofLog( OF_LOG_ERROR , "IisuRecordingFrameSource::open :: could not map " + path ) ;
+		return false ;
+	}
+
+	const unsigned char * data = file.getData() ;
+	size_t size = file.getSize() ;
+	if ( size < 8 || memcmp( data , IISU_RECORDING_MAGIC , 7 ) != 0 || data[7] != IISU_RECORDING_VERSION )
+	{
+		ofLog( OF_LOG_ERROR , "IisuRecordingFrameSource::open :: " + path + " is not an iisu recording" ) ;
+		close( ) ;
+		return false ;
+	}
+
+	//Walk the chunk headers once to build the frame index , a partial chunk at the end is ignored
+	size_t offset = 8 ;
+	while ( offset + 8 <= size )
+	{
+		IisuByteReader header( data + offset , 8 ) ;
+		uint32_t type = header.readUInt32( ) ;
+		uint32_t length = header.readUInt32( ) ;
+		if ( offset + 8 + length > size || length < 12 )
+			break ;
+
+		IisuByteReader payload( data + offset + 8 , length ) ;
+		IisuRecordingIndexEntry entry ;
+		entry.frameID = payload.readInt32( ) ;
+		entry.timestamp = payload.readDouble( ) ;
+		entry.offset = offset + 8 ;
+		entry.length = length ;
+		entry.bKeyframe = ( type == IISU_CHUNK_KEYFRAME ) ;
+		index.push_back( entry ) ;
+
+		offset += 8 + length ;
+	}
+
+	rewind( ) ;
+	return ( index.size() > 0 ) ;
+}
+
+void IisuRecordingFrameSource::close( )
+{
+	file.close( ) ;
+	index.clear() ;
+	currentLabel.clear() ;
+}
+
+void IisuRecordingFrameSource::rewind( )
+{
+	playhead = 0 ;
+	loopTimeOffset = 0.0 ;
+	currentLabel.clear() ;
+}
+
+bool IisuRecordingFrameSource::readFrame( IisuFrame &frame )
+{
+	if ( index.size() == 0 )
+		return false ;
+
+	if ( playhead >= index.size() )
+	{
+		if ( bLoop == false )
+			return false ;
+
+		//Keep time moving forward when we wrap around so native rate pacing still works
+		double duration = index.back().timestamp - index.front().timestamp ;
+		if ( index.size() > 1 )
+			duration += duration / ( index.size() - 1 ) ;
+		loopTimeOffset += duration ;
+		playhead = 0 ;
+		currentLabel.clear() ;
+	}
+
+	if ( decodeFrame( index[ playhead ] , frame ) == false )
+		return false ;
+
+	frame.timestamp += loopTimeOffset ;
+	playhead++ ;
+	return true ;
+}
+
+bool IisuRecordingFrameSource::seekToFrame( int32_t frameID )
+{
+	//Frame IDs only go up within a recording , so the index is sorted by them
+	int target = std::lower_bound( index.begin() , index.end() , frameID , IisuRecordingIndexEntry::isBefore ) - index.begin() ;
+
+	if ( target >= index.size() )
+		return false ;
+
+	//Label deltas need every frame back to the last keyframe
+	int keyframe = target ;
+	while ( keyframe > 0 && index[ keyframe ].bKeyframe == false )
+		keyframe-- ;
+
+	currentLabel.clear() ;
+	for ( int i = keyframe ; i < target ; i++ )
+	{
+		if ( decodeFrame( index[i] , seekFrame ) == false )
+			return false ;
+	}
+
+	playhead = target ;
+	return true ;
+}
+
+bool IisuRecordingFrameSource::decodeFrame( const IisuRecordingIndexEntry &entry , IisuFrame &frame )
+{
+	IisuByteReader reader( file.getData() + entry.offset , entry.length ) ;
+
+	//Start from a blank frame but keep the vectors' capacity
+	frame.frameID = reader.readInt32( ) ;
+	frame.timestamp = reader.readDouble( ) ;
+	frame.userIsActive = false ;
+	frame.user1SceneID = 0 ;
+	frame.user1MassCenter = Vector3( 0 , 0 , 0 ) ;
+	frame.skeletonStatus = 0 ;
+	frame.centroidCount = 0 ;
+	frame.keyPoints.clear() ;
+	frame.keyPointsConfidence.clear() ;
+	frame.centroidPositions.clear() ;
+	frame.centroidJumpStatus.clear() ;
+	frame.labelWidth = 0 ;
+	frame.labelHeight = 0 ;
+	frame.labelImage.clear() ;
+	frame.controllers.clear() ;
+	frame.hands.clear() ;
+	if ( frame.getNumUserSlots() == 0 )
+		frame.setNumUserSlots( 1 ) ;
+	frame.clearUsers() ;
+	frame.activeUsers.push_back( 0 ) ;
+
+	bool bHasLabel = false ;
+
+	while ( reader.bOk && reader.p < reader.end )
+	{
+		uint16_t field = reader.readUInt16( ) ;
+		uint16_t entity = reader.readUInt16( ) ;
+		uint32_t length = reader.readUInt32( ) ;
+		if ( !reader.has( length ) )
+			break ;
+
+		IisuByteReader data( reader.p , length ) ;
+		reader.p += length ;
+
+		switch ( field )
+		{
+			case IISU_FIELD_USER_IS_ACTIVE :
+				frame.userIsActive = ( data.readUInt8( ) != 0 ) ;
+				break ;
+
+			case IISU_FIELD_USER1_SCENE_ID :
+				frame.user1SceneID = data.readInt32( ) ;
+				break ;
+
+			case IISU_FIELD_USER1_MASS_CENTER :
+				frame.user1MassCenter = data.readVector3( ) ;
+				break ;
+
+			case IISU_FIELD_SKELETON_STATUS :
+				frame.skeletonStatus = data.readInt32( ) ;
+				break ;
+
+			case IISU_FIELD_KEY_POINTS :
+				for ( uint32_t i = 0 ; i < length / 12 ; i++ )
+					frame.keyPoints.push_back( data.readVector3( ) ) ;
+				break ;
+
+			case IISU_FIELD_KEY_POINTS_CONFIDENCE :
+				for ( uint32_t i = 0 ; i < length / 4 ; i++ )
+					frame.keyPointsConfidence.push_back( data.readFloat( ) ) ;
+				break ;
+
+			case IISU_FIELD_CENTROID_COUNT :
+				frame.centroidCount = data.readInt32( ) ;
+				break ;
+
+			case IISU_FIELD_CENTROID_POSITIONS :
+				for ( uint32_t i = 0 ; i < length / 12 ; i++ )
+					frame.centroidPositions.push_back( data.readVector3( ) ) ;
+				break ;
+
+			case IISU_FIELD_CENTROID_JUMP_STATUS :
+				for ( uint32_t i = 0 ; i < length / 4 ; i++ )
+					frame.centroidJumpStatus.push_back( data.readInt32( ) ) ;
+				break ;
+
+			case IISU_FIELD_LABEL_KEYFRAME :
+			case IISU_FIELD_LABEL_DELTA :
+			{
+				int width = data.readUInt16( ) ;
+				int height = data.readUInt16( ) ;
+				size_t pixels = width * height ;
+				frame.labelWidth = width ;
+				frame.labelHeight = height ;
+				frame.labelImage.resize( pixels ) ;
+				if ( pixels == 0 || decodeRuns( data , data.end - data.p , &frame.labelImage[0] , pixels ) == false )
+					return false ;
+
+				if ( field == IISU_FIELD_LABEL_DELTA )
+				{
+					//A delta without the frame before it can't be rebuilt
+					if ( currentLabel.size() != pixels )
+						return false ;
+					for ( size_t i = 0 ; i < pixels ; i++ )
+						frame.labelImage[i] ^= currentLabel[i] ;
+				}
+				currentLabel.assign( frame.labelImage.begin() , frame.labelImage.end() ) ;
+				bHasLabel = true ;
+				break ;
+			}
+
+			case IISU_FIELD_CONTROLLER :
+			{
+				if ( frame.controllers.size() <= entity )
+					frame.controllers.resize( entity + 1 ) ;
+				IisuControllerFrame &controller = frame.controllers[ entity ] ;
+				controller.isActive = ( data.readUInt8( ) != 0 ) ;
+				controller.status = data.readInt32( ) ;
+				controller.normalizedCoordinates = data.readVector3( ) ;
+				controller.worldCoordinates = data.readVector3( ) ;
+				break ;
+			}
+
+			case IISU_FIELD_HAND :
+			{
+				if ( frame.hands.size() <= entity )
+					frame.hands.resize( entity + 1 ) ;
+				IisuHandFrame &hand = frame.hands[ entity ] ;
+				hand.status = data.readInt32( ) ;
+				hand.palmPosition2D = data.readVector2( ) ;
+				hand.tipPosition2D = data.readVector2( ) ;
+				hand.isOpen = ( data.readUInt8( ) != 0 ) ;
+				hand.openAmount = data.readFloat( ) ;
+				uint32_t numStatus = data.readUInt32( ) ;
+				hand.fingerTipsStatus.clear() ;
+				for ( uint32_t f = 0 ; f < numStatus && data.bOk ; f++ )
+					hand.fingerTipsStatus.push_back( data.readInt32( ) ) ;
+				uint32_t numTips = data.readUInt32( ) ;
+				hand.fingerTips2D.clear() ;
+				for ( uint32_t f = 0 ; f < numTips && data.bOk ; f++ )
+					hand.fingerTips2D.push_back( data.readVector2( ) ) ;
+				break ;
+			}
+
+			case IISU_FIELD_USER :
+			{
+				if ( entity == 0 )
+					break ;
+
+				//Recorded with more users than the frame has room for
+				if ( frame.getNumUserSlots() <= entity )
+					frame.setNumUserSlots( entity + 1 ) ;
+				if ( frame.userActive[ entity ] )
+					break ;
+
+				frame.userActive[ entity ] = 1 ;
+				frame.userSceneIDs[ entity ] = data.readInt32( ) ;
+				frame.userSkeletonStatus[ entity ] = data.readInt32( ) ;
+				frame.userMassCenters[ entity ] = data.readVector3( ) ;
+				for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ )
+					frame.userKeyPoints[ entity * IISU_NUM_JOINTS + j ] = data.readVector3( ) ;
+				for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ )
+					frame.userKeyPointsConfidence[ entity * IISU_NUM_JOINTS + j ] = data.readFloat( ) ;
+				frame.activeUsers.push_back( entity ) ;
+				break ;
+			}
+
+			default :
+				//Unknown field from a newer writer , skip it
+				break ;
+		}
+	}
+
+	if ( bHasLabel == false )
+		currentLabel.clear() ;
+
+	//USER1 comes from the single user fields
+	frame.userActive[0] = 1 ;
+	frame.userSceneIDs[0] = frame.user1SceneID ;
+	frame.userSkeletonStatus[0] = frame.skeletonStatus ;
+	frame.userMassCenters[0] = frame.user1MassCenter ;
+	for ( int j = 0 ; j < frame.keyPoints.size() && j < IISU_NUM_JOINTS ; j++ )
+		frame.userKeyPoints[j] = frame.keyPoints[j] ;
+	for ( int j = 0 ; j < frame.keyPointsConfidence.size() && j < IISU_NUM_JOINTS ; j++ )
+		frame.userKeyPointsConfidence[j] = frame.keyPointsConfidence[j] ;
+
+	return reader.bOk ;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+/*
+	Binary recordings of IisuFrames ( .iisurec )
+
+	Layout , little endian :
+		header	: "IISUREC" + 1 byte version
+		chunks	: uint32 type , uint32 payload length , payload
+
+	Every chunk is one frame : int32 frameID , double timestamp and then a list of fields
+		uint16 field , uint16 entity index ( controller / hand # ) , uint32 length , data
+
+	The label image is run length encoded. A keyframe stores the whole image , the frames in between
+	store the XOR against the previous image which is almost all zeros and packs down to a few bytes.
+	Chunks are only ever appended so a recording that was cut short is still readable up to the last full chunk.
+*/
+
+#include "ofMain.h"
+#include "IisuFrame.h"
+#include "IisuFrameSource.h"
+#include "IisuAtomic.h"
+#include "IisuEventQueue.h"
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#define IISU_RECORDING_MAGIC "IISUREC"
+#define IISU_RECORDING_VERSION 1
+#define IISU_RECORDER_MAX_CHUNKS 1024		//maxPendingChunks is capped to this
+
+enum IisuRecordingChunk
+{
+	IISU_CHUNK_KEYFRAME = 1,		//decodes on its own
+	IISU_CHUNK_DELTA = 2			//label image depends on the previous frame
+};
+
+enum IisuRecordingField
+{
+	IISU_FIELD_USER_IS_ACTIVE = 1,
+	IISU_FIELD_USER1_SCENE_ID,
+	IISU_FIELD_USER1_MASS_CENTER,
+	IISU_FIELD_SKELETON_STATUS,
+	IISU_FIELD_KEY_POINTS,
+	IISU_FIELD_KEY_POINTS_CONFIDENCE,
+	IISU_FIELD_CENTROID_COUNT,
+	IISU_FIELD_CENTROID_POSITIONS,
+	IISU_FIELD_CENTROID_JUMP_STATUS,
+	IISU_FIELD_LABEL_KEYFRAME,
+	IISU_FIELD_LABEL_DELTA,
+	IISU_FIELD_CONTROLLER,
+	IISU_FIELD_HAND,
+	IISU_FIELD_USER					//USER2 and up , entity is the user slot. USER1 lives in the fields above
+};
+
+//Writes frames to disk. Frames are encoded on the calling thread , the disk writes happen on the recorder's own thread.
+//Chunk buffers are allocated in open() and only their indices go back and forth , so addFrame never locks or allocates
+class IisuRecorder : public ofThread
+{
+	public :
+		IisuRecorder( ) ;
+		~IisuRecorder( ) ;
+
+		//App thread. close() waits for a frame that's being added , nothing lands in the file after it returns
+		bool open( string path ) ;
+		void close( ) ;
+		bool isRecording( ) { return ( iisuAtomicLoad( &bRecording ) != 0 ) ; }
+
+		//App thread , before open(). Chunks are reserved for the biggest frame sizes has room for , IisuServer
+		//passes one of its preallocated frames. A frame bigger than that still records but allocates
+		void reserve( const IisuFrame &sizes ) ;
+		static size_t getMaxChunkSize( const IisuFrame &sizes ) ;
+
+		//iisu's thread
+		void addFrame( const IisuFrame &frame ) ;
+
+		int keyframeInterval ;			//frames between two full label images
+		int maxPendingChunks ;			//only if the disk falls this far behind are frames dropped
+
+		int getNumFrames( ) { return iisuAtomicLoad( &numFrames ) ; }
+		int getNumDroppedFrames( ) { return iisuAtomicLoad( &numDroppedFrames ) ; }
+		unsigned long long getBytesWritten( ) { return bytesWritten ; }
+
+	protected :
+		void threadedFunction( ) ;
+		void writePending( ) ;
+		void encodeFrame( const IisuFrame &frame , vector<unsigned char> &chunk ) ;
+
+		FILE * file ;
+		iisu_atomic_t bRecording ;
+		iisu_atomic_t numInFlight ;			//addFrame calls past the bRecording check
+		iisu_atomic_t bResetEncoder ;		//open() asks , the next addFrame starts over with a keyframe
+		vector< vector<unsigned char> > chunkPool ;
+		IisuEventQueue< int , IISU_RECORDER_MAX_CHUNKS > freeChunks ;		//pool indices , the writer hands them back to addFrame
+		IisuEventQueue< int , IISU_RECORDER_MAX_CHUNKS > filledChunks ;	//encoded chunks waiting for the disk
+		size_t chunkCapacity ;
+		size_t maxLabelPixels ;
+
+		//Encoder state , only touched by addFrame
+		vector<unsigned char> previousLabel ;
+		vector<unsigned char> labelDelta ;
+		int framesSinceKeyframe ;
+		iisu_atomic_t numFrames ;
+		iisu_atomic_t numDroppedFrames ;
+		unsigned long long bytesWritten ;
+};
+
+//Read only view of a whole file , memory mapped where the platform allows it
+class IisuMappedFile
+{
+	public :
+		IisuMappedFile( ) ;
+		~IisuMappedFile( ) { close( ) ; }
+
+		bool open( string path ) ;
+		void close( ) ;
+
+		const unsigned char * getData( ) { return data ; }
+		size_t getSize( ) { return size ; }
+
+	protected :
+		const unsigned char * data ;
+		size_t size ;
+#ifdef WIN32
+		HANDLE fileHandle ;
+		HANDLE mappingHandle ;
+#else
+		int fileDescriptor ;
+#endif
+};
+
+struct IisuRecordingIndexEntry
+{
+	int32_t		frameID ;
+	double		timestamp ;
+	size_t		offset ;				//start of the payload in the file
+	uint32_t	length ;
+	bool		bKeyframe ;
+
+	static bool isBefore( const IisuRecordingIndexEntry &entry , int32_t frameID ) { return entry.frameID < frameID ; }
+};
+
+//Replays a .iisurec file , frames can be read in order or looked up by frame ID
+class IisuRecordingFrameSource : public IisuFrameSource
+{
+	public :
+		IisuRecordingFrameSource( string _path = "" )
+		{
+			path = _path ;
+			playhead = 0 ;
+			bLoop = false ;
+		}
+
+		bool open( ) ;
+		void close( ) ;
+		bool readFrame( IisuFrame &frame ) ;
+		void rewind( ) ;
+
+		//Positions the source so the next readFrame returns frameID ( or the first frame after it )
+		bool seekToFrame( int32_t frameID ) ;
+		int getNumFrames( ) { return index.size() ; }
+
+		string path ;
+		bool bLoop ;
+
+	protected :
+		bool decodeFrame( const IisuRecordingIndexEntry &entry , IisuFrame &frame ) ;
+
+		IisuMappedFile file ;
+		vector<IisuRecordingIndexEntry> index ;
+		int playhead ;
+		double loopTimeOffset ;
+		vector<unsigned char> currentLabel ;		//label image of the last decoded frame , deltas apply on top of it
+		IisuFrame seekFrame ;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+/*
+	IisuSchema
+	The per controller and per hand iisu data , declared once. Every entity type is a path pattern , how many of
+	them iisu has and a list of FIELD( member , iisu type , path after the pattern ). The frame structs
+	( IisuControllerFrame , IisuHandFrame ) and the structs of handles that read them ( IisuControllerHandles ,
+	IisuHandHandles ) are both generated from that list , so a field can't be in one and missing from the other.
+	Paths are put together in a stack buffer when an entity is registered , nothing is looked up by name per frame.
+*/
+
+#include <SDK/iisuSDK.h>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+//UI.CONTROLLER#
+#define IISU_CONTROLLER_PATH "UI.CONTROLLER%d."
+#define IISU_MAX_CONTROLLERS 8
+#define IISU_CONTROLLER_FIELDS( FIELD ) \
+	FIELD( isActive ,				bool ,							"IsActive" ) \
+	FIELD( status ,					int32_t ,						"POINTER.Status" ) \
+	FIELD( normalizedCoordinates ,	SK::Vector3 ,					"POINTER.NormalizedCoordinates" ) \
+	FIELD( worldCoordinates ,		SK::Vector3 ,					"POINTER.WorldCoordinates" )
+
+//CI.HAND#
+#define IISU_HAND_PATH "CI.HAND%d."
+#define IISU_MAX_HANDS 2
+#define IISU_HAND_FIELDS( FIELD ) \
+	FIELD( status ,					int32_t ,						"Status" ) \
+	FIELD( palmPosition2D ,			SK::Vector2 ,					"PalmPosition2D" ) \
+	FIELD( tipPosition2D ,			SK::Vector2 ,					"TipPosition2D" ) \
+	FIELD( fingerTipsStatus ,		SK::Array<int32_t> ,			"FingerStatus" ) \
+	FIELD( fingerTips2D ,			SK::Array<SK::Vector2> ,		"FingerTipPositions2D" ) \
+	FIELD( isOpen ,					bool ,							"IsOpen" ) \
+	FIELD( openAmount ,				float ,							"Openness" )
+
+//Longest path a field can end up with , pattern and index included
+#define IISU_SCHEMA_MAX_PATH 128
+
+//What a field of iisu type T is kept as in a frame , arrays go into vectors so frames can reuse their capacity
+template<typename T> struct IisuFrameValue { typedef T type ; } ; 
+template<typename T> struct IisuFrameValue< SK::Array<T> > { typedef std::vector<T> type ; } ; 
+
+//path already holds the entity's pattern , prefixLength characters of it. Invalid handle when replaying ( no device )
+template<typename T>
+inline SK::DataHandle<T> registerIisuField( SK::Device * device , char * path , int prefixLength , const char * field , bool bAutoUpdate )
+{
+	if ( device == NULL || prefixLength < 0 || prefixLength + strlen( field ) >= IISU_SCHEMA_MAX_PATH )
+		return SK::DataHandle<T>( ) ; 
+	strcpy( path + prefixLength , field ) ; 
+	return device->registerDataHandle<T>( path , bAutoUpdate ) ; 
+}
+
+#define IISU_SCHEMA_VALUE( member , T , path )			IisuFrameValue< T >::type member ; 
+#define IISU_SCHEMA_DEFAULT( member , T , path )			member = IisuFrameValue< T >::type( ) ; 
+#define IISU_SCHEMA_HANDLE( member , T , path )			SK::DataHandle< T > member ; 
+#define IISU_SCHEMA_REGISTER( member , T , path )		member = registerIisuField< T >( device , fullPath , prefixLength , path , bAutoUpdate ) ; 
+#define IISU_SCHEMA_AUTO_UPDATE( member , T , path )		member.setAutoUpdate( bAutoUpdate ) ; 
+#define IISU_SCHEMA_FETCH( member , T , path )			fetchIisuValue( values.member , member ) ; 
+
+//One value per field , zeroed
+#define IISU_SCHEMA_VALUES( Name , FIELDS ) \
+struct Name \
+{ \
+	Name( ) { FIELDS( IISU_SCHEMA_DEFAULT ) } \
+	FIELDS( IISU_SCHEMA_VALUE ) \
+} ; 
+
+//One handle per field , index is 0 based like the cursor and hand IDs. fetch() reads every field into the frame
+//struct generated from the same list , it needs fetchIisuValue ( IisuFrame.h ) where it's expanded
+#define IISU_SCHEMA_HANDLES( Name , Values , PATH , FIELDS ) \
+struct Name \
+{ \
+	FIELDS( IISU_SCHEMA_HANDLE ) \
+	void registerAll( SK::Device * device , int index , bool bAutoUpdate ) \
+	{ \
+		char fullPath[ IISU_SCHEMA_MAX_PATH ] ; \
+		int prefixLength = sprintf( fullPath , PATH , index + 1 ) ; \
+		FIELDS( IISU_SCHEMA_REGISTER ) \
+	} \
+	void setAutoUpdate( bool bAutoUpdate ) { FIELDS( IISU_SCHEMA_AUTO_UPDATE ) } \
+	void fetch( Values &values ) { FIELDS( IISU_SCHEMA_FETCH ) } \
+} ; 
@@ -57,111 +57,204 @@ void IisuServer::setup( bool _bCloseInteraction )
 
 	registerEvents() ; 
 	initIisu() ; 
+
+	if ( acquisitionMode == IISU_ACQUIRE_THREAD && m_device != NULL ) 
+	{
+		acquisitionThread.iisu = this ; 
+		acquisitionThread.startThread( true , false ) ; 
+	}
 	m_skeletonStatus = 0 ; 
-	numHands = 0 ; 
+	numHands = handHandles.size() ; 
 }
 
-int IisuServer::addController( ) 
+void IisuServer::setup( IisuFrameSource * source , bool _bCloseInteraction , IisuReplayMode replayMode ) 
 {
-	int iisuIndex = controllerIsActiveData.size() + 1 ; 
+	bCloseInteraction = _bCloseInteraction ;
 
-	string pointerString = "UI.CONTROLLER" + ofToString( iisuIndex ) ;
+	bConnected = false ; 
+	m_skeletonStatus = 0 ; 
+	numHands = handHandles.size() ; 
 
-	string activeString = pointerString +".IsActive"  ; 
-	controllerIsActiveData.push_back(  m_device->registerDataHandle<bool>( activeString.c_str() ) ) ;
-	controllerIsActive.push_back ( false ) ; 
-	
-	string normalizedString = pointerString + ".POINTER.NormalizedCoordinates" ; 
-	pointerNormalizedCoordinatesData.push_back( m_device->registerDataHandle<Vector3>( normalizedString.c_str() ) );
-	pointerNormalizedCoordinates.push_back( Vector3( ) ) ; 
+	if ( source == NULL || source->open() == false ) 
+	{
+		cerr << "Failed to open iisu frame source!" << endl ; 
+		return ; 
+	}
+
+	frameSource = source ; 
+	bReplayClockSet = false ; 
 
-	//UI.CONTROLLER#.POINTER.WorldCoordinates
-	string statusString = pointerString + ".POINTER.Status" ; 
-	pointerStatusData.push_back( m_device->registerDataHandle<int32_t>(statusString.c_str() ) );
-	pointerStatus.push_back( 0 ) ;
+	if ( replayMode != IISU_REPLAY_MANUAL ) 
+	{
+		replayThread.iisu = this ; 
+		replayThread.bNativeRate = ( replayMode == IISU_REPLAY_NATIVE_RATE ) ; 
+		replayThread.startThread( true , false ) ; 
+	}
+}
 
+bool IisuServer::stepReplay( ) 
+{
+	if ( frameSource == NULL ) 
+		return false ; 
 
-	string globalString = pointerString + ".POINTER.WorldCoordinates" ; 
-	pointerGlobalCoordinatesData.push_back( m_device->registerDataHandle<Vector3>( globalString.c_str() ) ); 
-	pointerGlobalCoordinates.push_back( Vector3() ) ; 
+	if ( frameSource->readFrame( frameBuffer.getWriteBuffer() ) == false ) 
+		return false ; 
 
-	return ( iisuIndex - 1 ) ; 
-	
+	rebaseReplayFrame( frameBuffer.getWriteBuffer() ) ; 
+	frameBuffer.getWriteBuffer().deliveredMicros = IisuProfiler::bEnabled ? IisuProfiler::now() : 0 ; 
+	publishFrame( ) ; 
+	update( ) ; 
+	return true ; 
 }
-int IisuServer::addCloseInteractionHand ( ) 
+
+void IisuServer::stopReplay( ) 
 {
-	int iisuIndex = numHands + 1 ; 
-	string handString = "CI.HAND" + ofToString( iisuIndex ) + "." ;
+	replayThread.waitForThread( true ) ; 
 
-	string handStatus = handString + "Status" ; 
-	handStatusesHandle.push_back( m_device->registerDataHandle<int32_t>( handStatus.c_str() ) ) ; 
-	handStatuses.push_back ( 0 ) ; 
+	if ( frameSource != NULL ) 
+		frameSource->close( ) ; 
+}
 
-	string handPalmPosition2D = handString + "PalmPosition2D" ; 
-	handPalmPositions2DHandle.push_back( m_device->registerDataHandle<Vector2>( handPalmPosition2D.c_str() )) ; 
-	handPalmPositions2D.push_back( Vector2() ) ;
+void IisuReplayThread::threadedFunction( ) 
+{
+	unsigned long long startMicros = 0 ; 
+	double firstTimestamp = 0.0 ; 
+	bool bFirstFrame = true ; 
 
-	string handTipPosition2D = handString + "TipPosition2D" ;
-	handTipPositions2DHandle.push_back( m_device->registerDataHandle<Vector2>( handTipPosition2D.c_str() )) ;
-	handTipPositions2D.push_back( Vector2() ) ;
+	while ( isThreadRunning() ) 
+	{
+		IisuFrame &frame = iisu->frameBuffer.getWriteBuffer() ; 
+		if ( iisu->frameSource->readFrame( frame ) == false ) 
+			break ; 
 
-	string handFingerStatusString = handString + "FingerStatus" ; 
-	handFingerTipsStatusHandle.push_back( m_device->registerDataHandle<SK::Array<int32_t>>( handFingerStatusString.c_str() )) ;
-	SK::Array<int32_t> fingerArgs ;
-	//for ( int i = 0 ; i < 5 ; i++ ) fingerArgs.pushBack( 0 ) ; 
-	handFingerTipsStatus.push_back( fingerArgs ) ; 
+		if ( bNativeRate ) 
+		{
+			if ( bFirstFrame ) 
+			{
+				firstTimestamp = frame.timestamp ; 
+				startMicros = ofGetElapsedTimeMicros() ; 
+				bFirstFrame = false ; 
+			}
+
+			//Sleep until this frame is due relative to the first one
+			double due = frame.timestamp - firstTimestamp ; 
+			double elapsed = ( ofGetElapsedTimeMicros() - startMicros ) / 1000000.0 ; 
+			if ( due > elapsed ) 
+				ofSleepMillis( (int) ( ( due - elapsed ) * 1000.0 ) ) ; 
+		}
 
-	string handFingerTips2DString = handString + "FingerTipPositions2D" ; 
-	handFingerTips2DHandle.push_back( m_device->registerDataHandle<SK::Array<Vector2>>( handFingerTips2DString.c_str() )) ;
-	SK::Array<Vector2> fingerTipArgs ; 
+		//A replayed frame is "delivered" when it is due , the recorded time was only needed for pacing
+		iisu->rebaseReplayFrame( frame ) ; 
+		frame.deliveredMicros = IisuProfiler::bEnabled ? IisuProfiler::now() : 0 ; 
+		iisu->publishFrame( ) ; 
+	}
+}
 
-	handFingerTips2D.push_back( fingerTipArgs ) ; 
+void IisuServer::rebaseReplayFrame( IisuFrame &frame ) 
+{
+	//Only ever called from one thread , the replay thread or whoever calls stepReplay()
+	if ( bReplayClockSet == false ) 
+	{
+		replayFirstRecorded = frame.timestamp ; 
+		replayFirstApp = ofGetElapsedTimef() ; 
+		bReplayClockSet = true ; 
+	}
+	frame.timestamp = replayFirstApp + ( frame.timestamp - replayFirstRecorded ) ; 
+}
 
-	string handsOpenStatus = handString + "IsOpen" ; 
-	handsOpenHandle.push_back( m_device->registerDataHandle<bool>( handsOpenStatus.c_str() ) ) ; 
-	handsOpen.push_back( false ) ; 
+int IisuServer::addController( ) 
+{
+	int index = controllerHandles.size() ; 
+	if ( index >= IISU_MAX_CONTROLLERS ) 
+	{
+		cout << "IisuServer::addController :: iisu has no UI.CONTROLLER" << ( index + 1 ) << endl ; 
+		return -1 ; 
+	}
 
-	string handOpenAmount = handString + "Openness" ; 
-	handsOpenAmountHandle.push_back( m_device->registerDataHandle<float>( handOpenAmount.c_str() ) ) ; 
-	handsOpenAmount.push_back( 0.0f ) ; 
+	//Off until somebody subscribes to IISU_STREAM_CONTROLLERS , see applyStreams()
+	IisuControllerHandles handles ; 
+	handles.registerAll( m_device , index , false ) ; 
+	controllerHandles.push_back( handles ) ; 
+	controllers.push_back( IisuControllerFrame() ) ; 
+	lastControllerActive.push_back( 0 ) ; 
 
+	//Only now iisu's frame thread may look at it
+	iisuAtomicAdd( &numControllersPublished , 1 ) ; 
 
-	//vector<bool>								handsOpen ; 
-//		vector<float>								handsOpenAmount ; 	
+	return index ; 
+}
 
+int IisuServer::addCloseInteractionHand ( ) 
+{
+	int index = handHandles.size() ; 
+	if ( index >= IISU_MAX_HANDS ) 
+	{
+		cout << "IisuServer::addCloseInteractionHand :: iisu has no CI.HAND" << ( index + 1 ) << endl ; 
+		return -1 ; 
+	}
 
-	numHands++ ; 
+	//Off until somebody subscribes to IISU_STREAM_HANDS
+	IisuHandHandles handles ; 
+	handles.registerAll( m_device , index , false ) ; 
+	handHandles.push_back( handles ) ; 
+	hands.push_back( IisuHandFrame() ) ; 
+	numHands = handHandles.size() ; 
+	iisuAtomicAdd( &numHandsPublished , 1 ) ; 
 
-	return ( iisuIndex - 1 ) ; 
+	return index ; 
 }
 
 void IisuServer::initIisu() 
 {
+	//Replaying, there is nothing to register
+	if ( m_device == NULL || bIisuInitialized ) 
+		return ; 
+	bIisuInitialized = true ; 
+
 	//User
-	m_user1SceneID = m_device->registerDataHandle<int32_t>("USER1.SceneObjectID") ; 
 	m_userIsActiveData = m_device->registerDataHandle<bool>("USER.IsActive") ; 
 
-	//Volume + Skeleton
-	m_skeletonStatusData = m_device->registerDataHandle<int>("USER1.SKELETON.Status");
-	m_keyPointsData = m_device->registerDataHandle<Array<Vector3> >("USER1.SKELETON.KeyPoints");
-	m_keyPointsConfidenceData = m_device->registerDataHandle<Array<float> >("USER1.SKELETON.KeyPointsConfidence");
-	m_centroidCountParameter = m_device->registerParameterHandle<int32_t>( "SHAPE.CENTROIDS.Count" ) ; 
-	m_centroidPositionsData = m_device->registerDataHandle<SK::Array<SK::Vector3>>("USER1.SHAPE.CENTROIDS.Positions") ;
-	m_user1MassCenterData = m_device->registerDataHandle<Vector3>("USER1.MassCenter") ; 
-	m_centroidsJumpStatusHandle = m_device->registerDataHandle< Array<int> >("USER1.SHAPE.CENTROIDS.JumpStatus" ) ; 
-
-	//Camera
-	sceneImageHandle = m_device->registerDataHandle< SK::Image >("SCENE.LabelImage") ; 
-
-	m_centroidCountParameter.set( 150 ) ; 
+	//Every user is registered once up front , only USER1 updates until iisu says another one showed up
+	maxUsers = MAX( 1 , MIN( maxUsers , IISU_MAX_USERS ) ) ; 
+	userHandles.resize( maxUsers ) ; 
+	for ( int i = 0 ; i < maxUsers ; i++ ) 
+	{
+		string userString = "USER" + ofToString( i + 1 ) + "." ; 
+		bool bAutoUpdate = ( i == 0 ) ; 
+		IisuUserHandles &user = userHandles[i] ; 
+		user.sceneID = registerData<int32_t>( userString + "SceneObjectID" , bAutoUpdate ) ; 
+		user.massCenter = registerData<Vector3>( userString + "MassCenter" , bAutoUpdate ) ; 
+		user.skeletonStatus = registerData<int>( userString + "SKELETON.Status" , bAutoUpdate ) ; 
+		user.keyPoints = registerData< Array<Vector3> >( userString + "SKELETON.KeyPoints" , false ) ; 
+		user.keyPointsConfidence = registerData< Array<float> >( userString + "SKELETON.KeyPointsConfidence" , false ) ; 
+		userApplied[i] = bAutoUpdate ? 1 : 0 ; 
+	}
 
+	//Volume + Skeleton
+	m_user1SceneID = userHandles[0].sceneID ; 
+	m_user1MassCenterData = userHandles[0].massCenter ; 
+	m_skeletonStatusData = userHandles[0].skeletonStatus ; 
+	m_keyPointsData = userHandles[0].keyPoints ; 
+	m_keyPointsConfidenceData = userHandles[0].keyPointsConfidence ; 
+	m_centroidPositionsData = registerData< SK::Array<SK::Vector3> >( "USER1.SHAPE.CENTROIDS.Positions" , false ) ;
+	m_centroidsJumpStatusHandle = registerData< Array<int> >( "USER1.SHAPE.CENTROIDS.JumpStatus" , false ) ; 
+
+	//Camera , off like the centroids until somebody subscribes
+	sceneImageHandle = registerData< SK::Image >( "SCENE.LabelImage" , false ) ; 
+
+	//Every parameter in one batch , before the frames are sized for the centroid count
+	parameters.setup( m_device ) ; 
+	parameters.apply( "default" ) ; 
+	if ( startupProfile.empty() == false ) 
+		parameters.apply( startupProfile ) ; 
+	m_CI_Enabled = parameters.getBool( "CI.Enabled" ).get() ; 
+	preallocateFrames( ) ; 
 
 	
 	cout << "IS close interaction enabled m_CI_Enabled ? " << m_CI_Enabled << " bCloseInteraction : " << bCloseInteraction << endl ;
 
 	if ( bCloseInteraction == true ) 
 	{
-		m_CI_EnabledHandle = m_device->registerParameterHandle<bool>("CI.Enabled") ; 
 		Result res = m_device->getEventManager().registerEventListener( "CI.HandActivated" , *this , &IisuServer::handActivatedHandler ) ; 
 		if ( res.failed() )
 			cout << "failed to regsiter CI.HandActivated!" << endl ; 
@@ -174,21 +267,20 @@ void IisuServer::initIisu()
 		else
 			cout << "succesfully registered CI.HandDeactivated! " << endl ; 
 	}
+	Result userRes = m_device->getEventManager().registerEventListener( "UM.UserActivated" , *this , &IisuServer::onUserActivated ) ; 
+	if ( userRes.failed() ) 
+		cerr << "Failed to register in iisu for UM.UserActivated events!" << endl ; 
+
+	userRes = m_device->getEventManager().registerEventListener( "UM.UserDeactivated" , *this , &IisuServer::onUserDeactivated ) ; 
+	if ( userRes.failed() ) 
+		cerr << "Failed to register in iisu for UM.UserDeactivated events!" << endl ; 
+
 	// we need it check if applicatin is set-up properly
 	//m_uiEnabledParameter = m_device->registerParameterHandle<bool>("UI.Enabled");
 	//m_controllersCount = m_device->registerParameterHandle<int32_t>("UI.ControllerCount");
 
-	// we will use circle gestures to create controller and to start game, therefore...
-	// ...set-up activation gesture (for simplicity we will use just circle gesture)
-	ParameterHandle<bool> circleActivation = m_device->registerParameterHandle<bool>("UI.ACTIVATIONGESTURE.CIRCLE.Enabled");
-	circleActivation.set(true);
-
-	// ...make sure that gestures and circle gesture are enabled
-	ParameterHandle<bool> gesturesEnabled = m_device->registerParameterHandle<bool>("UI.CONTROLLERS.GESTURES.Enabled");
-	ParameterHandle<bool> circleGestureEnabled = m_device->registerParameterHandle<bool>("UI.CONTROLLERS.GESTURES.CIRCLE.Enabled");
-
-	gesturesEnabled.set(true);
-	circleGestureEnabled.set(true);
+	// we will use circle gestures to create controller and to start game , the circle activation and gestures
+	// are switched on by the "default" parameter profile above
 
 	// register this object to listen for UI.CONTROLLERS.Created event (we satrt game as soon as controller is created)
 	Result res = m_device->getEventManager().registerEventListener("UI.CONTROLLERS.Created", *this, &IisuServer::onControllerCreated);
@@ -197,6 +289,12 @@ void IisuServer::initIisu()
 		cerr << "Failed to register in iisu for UI.CONTROLLERS.Created events!" << endl;
 	}
 
+	res = m_device->getEventManager().registerEventListener("UI.CONTROLLERS.Destroyed", *this, &IisuServer::onControllerDestroyed);
+	if (res.failed()) 
+	{
+		cerr << "Failed to register in iisu for UI.CONTROLLERS.Destroyed events!" << endl;
+	}
+
 	// register this object to listen for UI.CONTROLLERS.GESTURES.CIRCLE.Detected event (we might have controller already
 	res = m_device->getEventManager().registerEventListener("UI.CONTROLLERS.GESTURES.CIRCLE.Detected", *this, &IisuServer::onCircleGesture);
 	if (res.failed()) 
@@ -214,14 +312,28 @@ void IisuServer::initIisu()
 	}
 }
 
-void IisuServer::handActivatedHandler( SK::HandActivatedEvent ) 
+void IisuServer::onUserActivated( SK::UserActivatedEvent event ) 
 {
-	cout << "hand activated! " << endl ;
+	//Only flag it here , the handles are switched on iisu's frame thread in applyStreams() before the next updateFrame
+	int user = event.getHumanoidID() - 1 ; 
+	if ( user >= 0 && user < maxUsers ) 
+		iisuAtomicStore( &userRequested[ user ] , 1 ) ; 
 }
-void IisuServer::handDeactivatedHandler( SK::HandDeactivatedEvent )
+
+void IisuServer::onUserDeactivated( SK::UserDeactivatedEvent event ) 
 {
-	cout << "hand deactivated! " << endl ; 
+	int user = event.getHumanoidID() - 1 ; 
+	if ( user >= 0 && user < maxUsers ) 
+		iisuAtomicStore( &userRequested[ user ] , 0 ) ; 
+}
 
+void IisuServer::handActivatedHandler( SK::HandActivatedEvent event ) 
+{
+	IisuEvents::Instance()->post( IISU_EVENT_HAND_ACTIVATED , event.getHandID() , 0 , iisuAtomicLoad( &latestFrameID ) ) ; 
+}
+void IisuServer::handDeactivatedHandler( SK::HandDeactivatedEvent event )
+{
+	IisuEvents::Instance()->post( IISU_EVENT_HAND_DEACTIVATED , event.getHandID() , 0 , iisuAtomicLoad( &latestFrameID ) ) ; 
 }
 
 
@@ -237,6 +349,12 @@ void IisuServer::onControllerCreated(ControllerCreationEvent event)
 	cout << "IisuServer::onControllerCreated !! " << endl ; 
 }
 
+void IisuServer::onControllerDestroyed(ControllerDestructionEvent event)
+{
+	//ROIs are numbered like UI.CONTROLLER# , from 1
+	IisuEvents::Instance()->post( IISU_EVENT_CURSOR_DESTROYED , event.getRoiID() - 1 , 0 , iisuAtomicLoad( &latestFrameID ) ) ; 
+}
+
 void IisuServer::onCircleGesture(CircleGestureEvent event)
 {
 	cout << "IisuServer::onCircleGesture !! " << endl ; 	
@@ -245,84 +363,523 @@ void IisuServer::onCircleGesture(CircleGestureEvent event)
 
 void IisuServer::onDataFrame(const DataFrameEvent& event)	
 {
-  	SK::Result resUpdate = m_device->updateFrame( false ) ; 
-	if(resUpdate.failed())
+	IISU_PROFILE_SCOPE( IISU_STAGE_DATA_FRAME ) ; 
+	unsigned long long deliveredMicros = IisuProfiler::bEnabled ? IisuProfiler::now() : 0 ; 
+
+	//Auto update has to be switched before updateFrame or a new stream's handles hold nothing for this frame
+	applyStreams( ) ; 
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_UPDATE_FRAME ) ; 
+  		SK::Result resUpdate = m_device->updateFrame( false ) ; 
+		if(resUpdate.failed())
+		{
+			cerr << "Failed to update data frame" << endl;
+
+		}
+	}
+
+	acquireFrame( deliveredMicros ) ; 
+}
+
+void IisuServer::acquireFrame( unsigned long long deliveredMicros ) 
+{
+	//releaseFrame() is iisu's business , only our side of the frame is counted
+	IisuAllocationCounter::begin( ) ; 
+	captureFrame( frameBuffer.getWriteBuffer() ) ; 
+	frameBuffer.getWriteBuffer().deliveredMicros = deliveredMicros ; 
+	int allocations = IisuAllocationCounter::end( ) ; 
+
+	// tell iisu we finished using data.
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_RELEASE_FRAME ) ; 
+		m_device->releaseFrame();
+	}
+
+	//Recording is counted with the rest , its chunks are reserved in open() so it only shows up for oversized frames
+	IisuAllocationCounter::begin( ) ; 
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_PUBLISH ) ; 
+		publishFrame( ) ; 
+	}
+	allocations += IisuAllocationCounter::end( ) ; 
+
+	lastFrameAllocations = allocations ; 
+	if ( allocations > 0 ) 
+		iisuAtomicAdd( &numAllocatingFrames , 1 ) ; 
+	iisuAtomicAdd( &numCapturedFrames , 1 ) ; 
+}
+
+void IisuAcquisitionThread::threadedFunction( ) 
+{
+#ifdef WIN32
+	if ( bHighPriority ) 
+		SetThreadPriority( GetCurrentThread() , THREAD_PRIORITY_ABOVE_NORMAL ) ; 
+	if ( affinityMask != 0 ) 
+		SetThreadAffinityMask( GetCurrentThread() , affinityMask ) ; 
+#endif
+
+	Device * device = iisu->m_device ; 
+	while ( isThreadRunning() ) 
+	{
+		//Subscriptions first , so the frame updateFrame fetches already has the streams captureFrame() reads
+		iisu->applyStreams( ) ; 
+
+		//Returns as soon as iisu has a frame we haven't seen , the timeout only lets us notice stopThread()
+		SK::Result resUpdate = device->updateFrame( true , timeoutMillis ) ; 
+		if ( resUpdate.failed() ) 
+		{
+			iisuAtomicAdd( &numTimeouts , 1 ) ; 
+			continue ; 
+		}
+
+		unsigned long long deliveredMicros = IisuProfiler::bEnabled ? IisuProfiler::now() : 0 ; 
+		device->lockFrame( ) ; 
+
+		//Nothing new , hand it straight back instead of copying the same data again
+		int32_t frameID = device->getDataFrame().getFrameID() ; 
+		if ( frameID == lastFrameID ) 
+		{
+			device->releaseFrame( ) ; 
+			iisuAtomicAdd( &numDuplicates , 1 ) ; 
+			continue ; 
+		}
+		lastFrameID = frameID ; 
+
+		IISU_PROFILE_SCOPE( IISU_STAGE_DATA_FRAME ) ; 
+		trackInterval( ) ; 
+		iisu->acquireFrame( deliveredMicros ) ; 
+		iisuAtomicAdd( &numFrames , 1 ) ; 
+	}
+}
+
+void IisuAcquisitionThread::trackInterval( ) 
+{
+	unsigned long long now = IisuProfiler::now() ; 
+	if ( lastFrameMicros != 0 ) 
 	{
-		cerr << "Failed to update data frame" << endl;
+		lastIntervalMicros = (float) ( now - lastFrameMicros ) ; 
+		if ( averageIntervalMicros == 0.0f ) 
+			averageIntervalMicros = lastIntervalMicros ; 
+		else
+			averageIntervalMicros += ( lastIntervalMicros - averageIntervalMicros ) * 0.05f ; 
 
+		if ( IisuProfiler::bEnabled ) 
+			IisuProfiler::Instance()->addSample( IISU_STAGE_FRAME_INTERVAL , lastIntervalMicros ) ; 
 	}
-	// the rest of the logic depends on iisu data, so we need to make sure that we have
-	// already a new data frame
-	const int32_t currentFrameID = m_device->getDataFrame().getFrameID();
-	if (currentFrameID == m_lastFrameID)
+	lastFrameMicros = now ; 
+}
+
+void IisuServer::preallocateFrames( ) 
+{
+	//Room for a full skeleton , every centroid and a QQVGA label image in each of the three buffers
+	int numCentroids = MAX( 150 , m_centroidCountParameter->get() ) ; 
+	for ( int i = 0 ; i < 3 ; i++ ) 
 	{
-		cout << "Same Frame as before" << endl ; 
+		frameBuffer.getBuffer( i ).reserve( SK::SkeletonEnum::_COUNT , numCentroids , 160 * 120 ) ; 
+		frameBuffer.getBuffer( i ).setNumUserSlots( maxUsers ) ; 
+	}
+	lastUserActive.assign( maxUsers , 0 ) ; 
+	recorder.reserve( frameBuffer.getBuffer( 0 ) ) ; 
+
+	m_keyPoints.setCapacity( SK::SkeletonEnum::_COUNT ) ; 
+	m_keyPointsConfidence.setCapacity( SK::SkeletonEnum::_COUNT ) ; 
+	m_centroidPositions.setCapacity( numCentroids ) ; 
+	m_centroidJumpStatus.setCapacity( numCentroids ) ; 
+}
+
+void IisuServer::publishFrame( ) 
+{
+	frameTracker.addFrame( frameBuffer.getWriteBuffer().frameID , IisuProfiler::now() ) ; 
+	iisuAtomicStore( &latestFrameID , frameBuffer.getWriteBuffer().frameID ) ; 
+	postFrameEvents( frameBuffer.getWriteBuffer() ) ; 
+
+	//Record on the producer side so frames the app thread skips still make it to disk
+	if ( recorder.isRecording() ) 
+		recorder.addFrame( frameBuffer.getWriteBuffer() ) ; 
+
+	frameBuffer.publish( ) ; 
+}
+
+void IisuServer::postFrameEvents( const IisuFrame &frame ) 
+{
+	//Compared on every published frame so transitions in frames the app thread skips aren't lost
+	//USER1 drives skeletonStatus , so that's the user these are about
+	if ( frame.skeletonStatus != last_skeletonStatus ) 
+	{
+		if ( frame.skeletonStatus != 0 ) 
+			IisuEvents::Instance()->post( IISU_EVENT_USER_DETECTED , 0 , 0 , frame.frameID ) ; 
+		else
+			IisuEvents::Instance()->post( IISU_EVENT_USER_LOST , 0 , 0 , frame.frameID ) ; 
+	}
+	last_skeletonStatus = frame.skeletonStatus ; 
+
+	//Users coming and going , by slot. Sized in preallocateFrames()
+	int numUsers = MIN( (int) lastUserActive.size() , frame.getNumUserSlots() ) ; 
+	for ( int i = 0 ; i < numUsers ; i++ ) 
+	{
+		if ( frame.userActive[i] == lastUserActive[i] ) 
+			continue ; 
+
+		lastUserActive[i] = frame.userActive[i] ; 
+		IisuEventType type = frame.userActive[i] ? IISU_EVENT_USER_ACTIVATED : IISU_EVENT_USER_DEACTIVATED ; 
+		IisuEvents::Instance()->post( type , i , 0 , frame.frameID ) ; 
+	}
+
+	//Controllers , addressed to the one cursor with that ID
+	int numControllers = MIN( (int) iisuAtomicLoad( &numControllersPublished ) , (int) frame.controllers.size() ) ; 
+	for ( int i = 0 ; i < numControllers ; i++ ) 
+	{
+		unsigned char bActive = frame.controllers[i].isActive ? 1 : 0 ; 
+		if ( bActive == lastControllerActive[i] ) 
+			continue ; 
+
+		lastControllerActive[i] = bActive ; 
+		IisuEventType type = bActive ? IISU_EVENT_CURSOR_DETECTED : IISU_EVENT_CURSOR_LOST ; 
+		IisuEvents::Instance()->post( type , i , 0 , frame.frameID ) ; 
+	}
+}
+
+bool IisuServer::update( ) 
+{
+	IISU_PROFILE_SCOPE( IISU_STAGE_SERVER_UPDATE ) ; 
+	//Listeners run here on the app thread , never inside iisu's callbacks
+	IisuEvents::Instance()->dispatchDeferred( ) ; 
+	frameTracker.checkHealth( IisuProfiler::now() ) ; 
+	if ( frameTracker.isStalled() ) 
 		bConnected = false ; 
-		//return;
+
+	if ( frameBuffer.update() == false ) 
+		return false ; 
+
+	frameTracker.addLatchedFrame( ) ; 
+
+	IisuProfiler::Instance()->markLatched( frameBuffer.getReadBuffer() ) ; 
+	processFrame( frameBuffer.getReadBuffer() ) ; 
+	return true ; 
+}
+
+void IisuServer::subscribe( int streams ) 
+{
+	for ( int i = 0 ; i < IISU_NUM_STREAMS ; i++ ) 
+	{
+		if ( streams & ( 1 << i ) ) 
+			iisuAtomicAdd( &streamSubscribers[i] , 1 ) ; 
 	}
-	else
+}
+
+void IisuServer::unsubscribe( int streams ) 
+{
+	for ( int i = 0 ; i < IISU_NUM_STREAMS ; i++ ) 
 	{
-		//cout << "frame# " << currentFrameID << endl ; 
-		bConnected = true ; 
+		if ( ( streams & ( 1 << i ) ) && iisuAtomicAdd( &streamSubscribers[i] , -1 ) < 0 ) 
+			iisuAtomicAdd( &streamSubscribers[i] , 1 ) ; 
 	}
+}
 
-	// remember current frame id
-	m_lastFrameID = currentFrameID;
+int IisuServer::getSubscribedStreams( ) 
+{
+	int streams = IISU_STREAM_NONE ; 
+	for ( int i = 0 ; i < IISU_NUM_STREAMS ; i++ ) 
+	{
+		if ( iisuAtomicLoad( &streamSubscribers[i] ) > 0 ) 
+			streams |= ( 1 << i ) ; 
+	}
+	return streams ; 
+}
+
+void IisuServer::applyStreams( ) 
+{
+	//iisu's frame thread , only touches the handles when the subscriptions or the number of controllers / hands changed
+	int streams = getSubscribedStreams( ) ; 
+
+	//Users come and go with iisu's user events , their handles are switched per user
+	bool bUserSkeletons = ( streams & IISU_STREAM_SKELETON ) != 0 ; 
+	for ( int i = 0 ; i < userHandles.size() ; i++ ) 
+	{
+		bool bWanted = ( i == 0 || iisuAtomicLoad( &userRequested[i] ) != 0 ) ; 
+		int state = bWanted ? ( bUserSkeletons ? 2 : 1 ) : 0 ; 
+		if ( state != userApplied[i] ) 
+		{
+			userHandles[i].setAutoUpdate( bWanted , bUserSkeletons ) ; 
+			userApplied[i] = state ; 
+		}
+	}
+
+	int numControllers = iisuAtomicLoad( &numControllersPublished ) ; 
+	int numHandsAdded = iisuAtomicLoad( &numHandsPublished ) ; 
+	if ( streams == streamsApplied && numControllersApplied == numControllers && numHandsApplied == numHandsAdded ) 
+		return ; 
+
+	bool bCentroids = ( streams & IISU_STREAM_CENTROIDS ) != 0 ; 
+	m_centroidPositionsData.setAutoUpdate( bCentroids ) ; 
+	m_centroidsJumpStatusHandle.setAutoUpdate( bCentroids ) ; 
+	sceneImageHandle.setAutoUpdate( ( streams & IISU_STREAM_LABEL_IMAGE ) != 0 ) ; 
+
+	bool bControllers = ( streams & IISU_STREAM_CONTROLLERS ) != 0 ; 
+	for ( int i = 0 ; i < numControllers ; i++ ) 
+		controllerHandles[i].setAutoUpdate( bControllers ) ; 
+
+	bool bHands = ( streams & IISU_STREAM_HANDS ) != 0 ; 
+	for ( int i = 0 ; i < numHandsAdded ; i++ ) 
+		handHandles[i].setAutoUpdate( bHands ) ; 
+
+	streamsApplied = streams ; 
+	numControllersApplied = numControllers ; 
+	numHandsApplied = numHandsAdded ; 
+}
+
+bool IisuServer::startRecording( string path ) 
+{
+	if ( recorder.open( path ) == false ) 
+		return false ; 
+	if ( bRecordingStreams == false ) 
+		subscribe( IISU_STREAM_ALL ) ; 
+	bRecordingStreams = true ; 
+	return true ; 
+}
+
+void IisuServer::stopRecording( ) 
+{
+	recorder.close( ) ; 
+	if ( bRecordingStreams ) 
+		unsubscribe( IISU_STREAM_ALL ) ; 
+	bRecordingStreams = false ; 
+}
+
+void IisuServer::captureFrame( IisuFrame &frame ) 
+{
+	//streamsApplied is what was switched on before updateFrame , see onDataFrame() and IisuAcquisitionThread
+	frame.frameID = m_device->getDataFrame().getFrameID();
+	frame.timestamp = ofGetElapsedTimef() ; 
 
 	//USER
-	m_user1MassCenter = m_user1MassCenterData.get() ; 
-	m_userIsActive = m_userIsActiveData.get() ; 
-	sceneImage = sceneImageHandle.get() ; 
-	user1SceneID = m_user1SceneID.get() ;
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_GET_USERS ) ; 
+		frame.userIsActive = m_userIsActiveData.get() ; 
+		captureUsers( frame ) ; 
+		frame.user1MassCenter = frame.userMassCenters[0] ; 
+		frame.user1SceneID = frame.userSceneIDs[0] ;
+	}
+
+	//Camera
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_GET_LABEL_IMAGE ) ; 
+		if ( ( streamsApplied & IISU_STREAM_LABEL_IMAGE ) && sceneImageHandle.isValid() ) 
+		{
+			const SK::Image &image = sceneImageHandle.get() ; 
+			SK::ImageInfos infos = image.getImageInfos() ; 
+			frame.labelWidth = infos.width ; 
+			frame.labelHeight = infos.height ; 
+			frame.labelImage.assign( image.getRAW() , image.getRAW() + infos.bytesRAW() ) ; 
+		}
+		else
+		{
+			frame.labelWidth = 0 ; 
+			frame.labelHeight = 0 ; 
+			frame.labelImage.clear() ; 
+		}
+	}
 
 	//Look through all our cursor data
-	for ( int i = 0 ; i < pointerStatusData.size() ; i++ ) 
 	{
-		pointerStatus[ i ]  = pointerStatusData[ i ].get() ; 
-		pointerNormalizedCoordinates[ i ] = pointerNormalizedCoordinatesData[ i ].get() ; 
-		controllerIsActive[ i ] = controllerIsActiveData[ i ].get( ) ; 
-		pointerGlobalCoordinates[ i ] = pointerGlobalCoordinatesData[ i ].get() ; 
+		IISU_PROFILE_SCOPE( IISU_STAGE_GET_CONTROLLERS ) ; 
+		frame.controllers.resize( ( streamsApplied & IISU_STREAM_CONTROLLERS ) ? numControllersApplied : 0 ) ; 
+		for ( int i = 0 ; i < frame.controllers.size() ; i++ ) 
+			controllerHandles[ i ].fetch( frame.controllers[ i ] ) ; 
 	}
 
-	if ( bCloseInteraction ) 
+	frame.hands.clear() ; 
+	if ( bCloseInteraction && ( streamsApplied & IISU_STREAM_HANDS ) ) 
+	{
+		IISU_PROFILE_SCOPE( IISU_STAGE_GET_HANDS ) ; 
+		frame.hands.resize( numHandsApplied ) ; 
+		for ( int i = 0 ; i < frame.hands.size() ; i++ ) 
+			handHandles[ i ].fetch( frame.hands[ i ] ) ; 
+	}
+	
+	//Skeleton + Volume
+	IISU_PROFILE_SCOPE( IISU_STAGE_GET_SHAPE ) ; 
+	bool bCentroids = ( streamsApplied & IISU_STREAM_CENTROIDS ) != 0 ; 
+	if ( bCentroids ) 
+	{
+		frame.centroidCount = m_centroidCountParameter->get() ; 
+		copyIisuArray( frame.centroidPositions , m_centroidPositionsData.get() ) ; 
+	}
+	else
+	{
+		frame.centroidCount = 0 ; 
+		frame.centroidPositions.clear() ; 
+	}
+	frame.skeletonStatus = frame.userSkeletonStatus[0] ; 	
+
+	//Buffers get reused every third frame so anything not read this frame is cleared ,
+	//processFrame keeps the last tracked key points around like before
+	if ( frame.skeletonStatus != 0 ) 
 	{
-		for ( int i = 0 ; i < handStatuses.size() ; i++ ) 
+		frame.keyPoints.assign( frame.getUserKeyPoints( 0 ) , frame.getUserKeyPoints( 0 ) + IISU_NUM_JOINTS ) ; 
+		frame.keyPointsConfidence.assign( frame.getUserKeyPointsConfidence( 0 ) , frame.getUserKeyPointsConfidence( 0 ) + IISU_NUM_JOINTS ) ; 
+		if ( bCentroids ) 
+			copyIisuArray( frame.centroidJumpStatus , m_centroidsJumpStatusHandle.get( ) ) ; 
+		else
+			frame.centroidJumpStatus.clear() ; 
+	}
+	else
+	{
+		frame.keyPoints.clear() ; 
+		frame.keyPointsConfidence.clear() ; 
+		frame.centroidJumpStatus.clear() ; 
+	}
+}
+
+void IisuServer::captureUsers( IisuFrame &frame ) 
+{
+	if ( frame.getNumUserSlots() != userHandles.size() ) 
+		frame.setNumUserSlots( userHandles.size() ) ; 
+
+	frame.clearUsers( ) ; 
+	bool bSkeleton = ( streamsApplied & IISU_STREAM_SKELETON ) != 0 ; 
+	for ( int i = 0 ; i < userHandles.size() ; i++ ) 
+	{
+		//Only users switched on before updateFrame have this frame's data , see applyStreams()
+		if ( userApplied[i] == 0 ) 
+			continue ; 
+
+		IisuUserHandles &user = userHandles[i] ; 
+		frame.activeUsers.push_back( i ) ; 
+		frame.userActive[i] = 1 ; 
+		frame.userSceneIDs[i] = user.sceneID.get() ; 
+		frame.userMassCenters[i] = user.massCenter.get() ; 
+		frame.userSkeletonStatus[i] = user.skeletonStatus.get() ; 
+		Vector3 * keyPointsOut = &frame.userKeyPoints[ i * IISU_NUM_JOINTS ] ; 
+		float * confidenceOut = &frame.userKeyPointsConfidence[ i * IISU_NUM_JOINTS ] ; 
+		if ( frame.userSkeletonStatus[i] == 0 || bSkeleton == false ) 
 		{
-			handStatuses[i] = handStatusesHandle[i].get() ; 
-			handPalmPositions2D[i] = handPalmPositions2DHandle[i].get() ; 
-			handTipPositions2D[i] = handTipPositions2DHandle[i].get() ; 
-			handsOpen[i] = handsOpenHandle[i].get() ; 
-			handsOpenAmount[i] = handsOpenAmountHandle[i].get() ; 
-			handFingerTipsStatus[i] = handFingerTipsStatusHandle[i].get() ; 
-			handFingerTips2D[i] = handFingerTips2DHandle[i].get() ;
+			//Active without a skeleton , nothing of an older frame may stay in the rows
+			for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+			{
+				keyPointsOut[j] = Vector3( 0 , 0 , 0 ) ; 
+				confidenceOut[j] = 0.0f ; 
+			}
+			continue ; 
 		}
+
+		//Straight into the user's rows , one pass per array
+		const SK::Array<SK::Vector3> &keyPoints = user.keyPoints.get() ; 
+		const SK::Array<float> &confidence = user.keyPointsConfidence.get() ; 
+		int numKeyPoints = MIN( keyPoints.size() , IISU_NUM_JOINTS ) ; 
+		for ( int j = 0 ; j < numKeyPoints ; j++ ) 
+			keyPointsOut[j] = keyPoints[j] ; 
+		int numConfidence = MIN( confidence.size() , IISU_NUM_JOINTS ) ; 
+		for ( int j = 0 ; j < numConfidence ; j++ ) 
+			confidenceOut[j] = confidence[j] ; 
+	}
+}
+
+void IisuServer::processFrame( const IisuFrame &frame ) 
+{
+	//Duplicates are counted by frameTracker , only a stall ( see update() ) means we lost the device
+	if ( frame.frameID != m_lastFrameID )
+		bConnected = true ; 
+
+	// remember current frame id
+	m_lastFrameID = frame.frameID ;
+
+	//USER
+	m_user1MassCenter = frame.user1MassCenter ; 
+	m_userIsActive = frame.userIsActive ; 
+	user1SceneID = frame.user1SceneID ;
+
+	//Look through all our cursor data , a recording may hold more controllers than were added
+	int numControllers = MIN( controllers.size() , frame.controllers.size() ) ; 
+	for ( int i = 0 ; i < numControllers ; i++ ) 
+		controllers[ i ] = frame.controllers[ i ] ; 
+
+	if ( bCloseInteraction ) 
+	{
+		//Vector members keep their capacity , nothing allocates once the finger counts settled
+		int numFrameHands = MIN( hands.size() , frame.hands.size() ) ; 
+		for ( int i = 0 ; i < numFrameHands ; i++ ) 
+			hands[i] = frame.hands[ i ] ; 
 	}
 	
 	//Skeleton + Volume
-	m_centroidCount = m_centroidCountParameter.get() ; 
-	m_centroidPositions = m_centroidPositionsData.get() ; 
-	m_skeletonStatus = m_skeletonStatusData.get() ; 	
+	m_centroidCount = frame.centroidCount ; 
+	assignIisuArray( m_centroidPositions , frame.centroidPositions ) ; 
+	m_skeletonStatus = frame.skeletonStatus ; 	
 
 	if ( m_skeletonStatus != 0 ) 
 	{
-		m_keyPoints = m_keyPointsData.get() ; 
-		m_keyPointsConfidence = m_keyPointsConfidenceData.get() ; 
-		m_centroidJumpStatus = m_centroidsJumpStatusHandle.get( ) ; 
+		assignIisuArray( m_keyPoints , frame.keyPoints ) ; 
+		assignIisuArray( m_keyPointsConfidence , frame.keyPointsConfidence ) ; 
+		assignIisuArray( m_centroidJumpStatus , frame.centroidJumpStatus ) ; 
 	}
 
-	if ( m_skeletonStatus != last_skeletonStatus ) 
+	//Prediction history , a user that lost tracking starts over
+	int numPredicted = MIN( maxUsers , IISU_MAX_USERS ) ; 
+	for ( int i = 0 ; i < numPredicted ; i++ ) 
 	{
-		int args = 9 ; 
-		if ( m_skeletonStatus != 0 ) 
-			ofNotifyEvent( IisuEvents::Instance()->USER_DETECTED , args ) ; 
+		const Vector3 * keyPoints = getUserKeyPoints( i ) ; 
+		if ( getUserSkeletonStatus( i ) != 0 && keyPoints != NULL ) 
+			keyPointPredictors[i].addFrame( frame.timestamp , keyPoints , getUserKeyPointsConfidence( i ) ) ; 
 		else
-			ofNotifyEvent( IisuEvents::Instance()->USER_LOST , args ) ; 
+			keyPointPredictors[i].reset( ) ; 
 	}
+}
 
-	// tell iisu we finished using data.
-	m_device->releaseFrame();
+const Vector3 * IisuServer::getPredictedKeyPoints( double targetTime , int user ) 
+{
+	if ( user < 0 || user >= IISU_MAX_USERS || keyPointPredictors[ user ].hasFrame() == false ) 
+		return NULL ; 
+	return keyPointPredictors[ user ].predict( targetTime ) ; 
+}
+
+bool IisuServer::isUserActive( int user ) 
+{
+	const IisuFrame &frame = getFrame() ; 
+	if ( user >= 0 && user < frame.getNumUserSlots() ) 
+		return ( frame.userActive[ user ] != 0 ) ; 
+	return false ; 
+}
+
+int IisuServer::getUserSkeletonStatus( int user ) 
+{
+	if ( isUserActive( user ) ) 
+		return getFrame().userSkeletonStatus[ user ] ; 
 
-	last_skeletonStatus = m_skeletonStatus ;
+	//Frames built without per user data still carry USER1
+	return ( user == 0 ) ? m_skeletonStatus : 0 ; 
+}
+
+int IisuServer::getUserSceneID( int user ) 
+{
+	if ( isUserActive( user ) ) 
+		return getFrame().userSceneIDs[ user ] ; 
+	return ( user == 0 ) ? user1SceneID : 0 ; 
+}
+
+Vector3 IisuServer::getUserMassCenter( int user ) 
+{
+	if ( isUserActive( user ) ) 
+		return getFrame().userMassCenters[ user ] ; 
+	return ( user == 0 ) ? m_user1MassCenter : Vector3( 0 , 0 , 0 ) ; 
+}
+
+const Vector3 * IisuServer::getUserKeyPoints( int user ) 
+{
+	if ( isUserActive( user ) ) 
+		return getFrame().getUserKeyPoints( user ) ; 
+	if ( user == 0 && m_keyPoints.size() >= IISU_NUM_JOINTS ) 
+		return &m_keyPoints[0] ; 
+	return NULL ; 
+}
+
+const float * IisuServer::getUserKeyPointsConfidence( int user ) 
+{
+	if ( isUserActive( user ) ) 
+		return getFrame().getUserKeyPointsConfidence( user ) ; 
+	if ( user == 0 && m_keyPointsConfidence.size() >= IISU_NUM_JOINTS ) 
+		return &m_keyPointsConfidence[0] ; 
+	return NULL ; 
 }
 
 void IisuServer::registerEvents ( ) 
@@ -343,14 +900,17 @@ void IisuServer::registerEvents ( )
 		exit();
 	}
 
-	// a new dataframe has been computed by iisu
-	ret = m_iisuHandle->getEventManager().registerEventListener("DEVICE.DataFrame", *this, &IisuServer::onDataFrame);
-	if (ret.failed()) 
+	// a new dataframe has been computed by iisu , unless our own thread asks for the frames
+	if ( acquisitionMode == IISU_ACQUIRE_ON_DATA_FRAME ) 
 	{
-		cerr << "Failed to register for data frame events!" << endl
-			<< "Error " << ret.getErrorCode() << ": " << ret.getDescription().ptr() << endl;
-		getchar();
-		exit();
+		ret = m_iisuHandle->getEventManager().registerEventListener("DEVICE.DataFrame", *this, &IisuServer::onDataFrame);
+		if (ret.failed()) 
+		{
+			cerr << "Failed to register for data frame events!" << endl
+				<< "Error " << ret.getErrorCode() << ": " << ret.getDescription().ptr() << endl;
+			getchar();
+			exit();
+		}
 	}
 
 	if ( bCloseInteraction )
@@ -390,34 +950,14 @@ void IisuServer::registerEvents ( )
 
 void IisuServer::handPoseGestureHandler ( SK::HandPosingGestureEvent e ) 
 {
-	//Get posing metaInfo
-	SK::Return<SK::MetaInfo<SK::HandPosingGestureEvent> > retMetaInfo = m_device->getEventManager().getMetaInfo<SK::HandPosingGestureEvent>("CI.HandPosingGesture") ; 
-
-	if ( retMetaInfo.succeeded() ) 
-	{
-		SK::MetaInfo<SK::HandPosingGestureEvent> poseMetaInfo = retMetaInfo.get() ; 
-		const SK::EnumMapper &enumMapper = poseMetaInfo.getEnumMapper() ; 
-
-		int gestureID = e.getGestureTypeID() ; 
-		SK::Return<SK::String> retPosingGestureName = enumMapper[gestureID] ; 
-		if ( retPosingGestureName.succeeded() ) 
-		{
-			SK::String gestureName = retPosingGestureName.get() ; 
-			cout << "pose: " << gestureName << "   _ gestureTypeID : " << e.getGestureTypeID() << "   _ firstHand ID: " << e.getFirstHandID() << endl ; 
-			int args =  e.getGestureTypeID() ; 
-			ofNotifyEvent( IisuEvents::Instance()->POSE_GESTURE , args ) ; 
-		}
-	}
-	else
-	{
-		cout << "meta Info did not succeed! " << endl ; 
-	}
+	//iisu's thread , the gesture name can be looked up through CI.HandPosingGesture's meta info on the app side
+	IisuEvents::Instance()->post( IISU_EVENT_POSE_GESTURE , e.getFirstHandID() , e.getGestureTypeID() , iisuAtomicLoad( &latestFrameID ) ) ; 
 }
 
 int IisuServer::getCursorStatus ( int cursorID ) 
 {
-	if ( cursorID < pointerStatus.size() ) 
-		return pointerStatus[ cursorID ] ; 
+	if ( cursorID < controllers.size() ) 
+		return controllers[ cursorID ].status ; 
 	else
 		cout << "IisuServer::getCursorStatus :: INVALID INDEX" << endl ; 
 	
@@ -427,8 +967,8 @@ int IisuServer::getCursorStatus ( int cursorID )
 
 Vector3 IisuServer::getNormalizedCursorCoordinates ( int cursorID ) 
 {	
-	if ( cursorID < pointerStatus.size() ) 
-		return pointerNormalizedCoordinates[ cursorID ] ;
+	if ( cursorID < controllers.size() ) 
+		return controllers[ cursorID ].normalizedCoordinates ;
 	else
 		cout << "IisuServer::getNormalizedCursorCoordinates :: INVALID INDEX" << endl ;
 
@@ -437,8 +977,8 @@ Vector3 IisuServer::getNormalizedCursorCoordinates ( int cursorID )
 
 Vector3 IisuServer::getWorldCursorPosition( int cursorID ) 
 {
-	if ( cursorID < pointerStatus.size() ) 
-		return pointerGlobalCoordinates[ cursorID ] ;
+	if ( cursorID < controllers.size() ) 
+		return controllers[ cursorID ].worldCoordinates ;
 	else
 		cout << "IisuServer::getNormalizedCursorCoordinates :: INVALID INDEX" << endl ;
 
@@ -447,8 +987,20 @@ Vector3 IisuServer::getWorldCursorPosition( int cursorID )
 
 void IisuServer::exit ( int exitCode ) 
 {
-	m_iisuHandle->getEventManager().unregisterEventListener( "SYSTEM.Error" , *this , &IisuServer::onError ) ; 
-	m_iisuHandle->getEventManager().unregisterEventListener( "DEVICE.DataFrame" , *this , &IisuServer::onDataFrame );
+	if ( m_iisuHandle != NULL ) 
+	{
+		m_iisuHandle->getEventManager().unregisterEventListener( "SYSTEM.Error" , *this , &IisuServer::onError ) ; 
+		m_iisuHandle->getEventManager().unregisterEventListener( "DEVICE.DataFrame" , *this , &IisuServer::onDataFrame );
+	}
+
+	//Has to be stopped before the device goes away , updateFrame returns within timeoutMillis
+	if ( acquisitionThread.isThreadRunning() ) 
+		acquisitionThread.waitForThread( true ) ; 
+
+	if ( isReplaying() ) 
+		stopReplay( ) ; 
+
+	stopRecording( ) ; 
 	
 	cout << "IISU ERROR ! Exit Code of : " << exitCode << endl ; 
 
@@ -457,8 +1009,8 @@ void IisuServer::exit ( int exitCode )
 
 int IisuServer::getHandStatus ( int handID ) 
 {
-	if ( handID < handStatuses.size() ) 
-		return handStatuses[ handID ] ; 
+	if ( handID < hands.size() ) 
+		return hands[ handID ].status ; 
 	else
 		cout << "IisuServer::getHandStatus :: INVALID INDEX" << endl ;
 
@@ -467,8 +1019,8 @@ int IisuServer::getHandStatus ( int handID )
 	
 Vector2 IisuServer::getHandPalmPosition2D ( int handID ) 
 {
-	if ( handID < handPalmPositions2D.size() ) 
-		return handPalmPositions2D[ handID ] ; 
+	if ( handID < hands.size() ) 
+		return hands[ handID ].palmPosition2D ; 
 	else
 		cout << "IisuServer::getHandPalmPosition2D :: INVALID INDEX" << endl ;
 
@@ -477,8 +1029,8 @@ Vector2 IisuServer::getHandPalmPosition2D ( int handID )
 
 Vector2 IisuServer::getHandTipPosition2D( int handID ) 
 {
-	if ( handID < handTipPositions2D.size() ) 
-		return handTipPositions2D[ handID ] ; 
+	if ( handID < hands.size() ) 
+		return hands[ handID ].tipPosition2D ; 
 	else
 		cout << "IisuServer::getHandTipPosition2D :: INVALID INDEX" << endl ;
 
@@ -487,8 +1039,8 @@ Vector2 IisuServer::getHandTipPosition2D( int handID )
 
 bool IisuServer::getHandsOpen ( int handID ) 
 {
-	if ( handID < handsOpen.size() ) 
-		return handsOpen[ handID ] ; 
+	if ( handID < hands.size() ) 
+		return hands[ handID ].isOpen ; 
 	else
 		cout << "IisuServer::getHandsOpen :: INVALID INDEX" << endl ;
 
@@ -497,32 +1049,40 @@ bool IisuServer::getHandsOpen ( int handID )
 
 float IisuServer::getHandsOpenAmount ( int handID ) 
 {
-	if ( handID < handsOpenAmount.size() ) 
-		return handsOpenAmount[ handID ] ; 
+	if ( handID < hands.size() ) 
+		return hands[ handID ].openAmount ; 
 	else
 		cout << "IisuServer::getHandsOpenAmount :: INVALID INDEX" << endl ;
 
 	return 0.0f ; 
 }
 
-SK::Array<int32_t> IisuServer::getHandsFingerTipsStatus ( int handID ) 
+IisuArrayView<int32_t> IisuServer::getHandFingerTipsStatusView( int handID ) 
 {
-	if ( handID < handFingerTipsStatus.size() ) 
-		return handFingerTipsStatus[handID] ; 
-	else
-		cout << "IisuServer::getHandsOpenAmount :: INVALID INDEX" << endl ;
+	const IisuFrame &frame = getFrame() ; 
+	if ( handID >= 0 && handID < frame.hands.size() ) 
+		return IisuArrayView<int32_t>( frame.hands[ handID ].fingerTipsStatus ) ; 
+	return IisuArrayView<int32_t>() ; 
+}
+
+IisuArrayView<Vector2> IisuServer::getHandFingerTips2DView( int handID ) 
+{
+	const IisuFrame &frame = getFrame() ; 
+	if ( handID >= 0 && handID < frame.hands.size() ) 
+		return IisuArrayView<Vector2>( frame.hands[ handID ].fingerTips2D ) ; 
+	return IisuArrayView<Vector2>() ; 
+}
 
+SK::Array<int32_t> IisuServer::getHandsFingerTipsStatus ( int handID ) 
+{
 	SK::Array<int32_t> args ; 
-	return args;  
+	assignIisuArray( args , getHandFingerTipsStatusView( handID ) ) ; 
+	return args ; 
 }
 
 SK::Array<Vector2> IisuServer::getHandsFingerTips2D ( int handID ) 
 {
-	if ( handID < handFingerTips2D.size() ) 
-		return handFingerTips2D[ handID ] ; 
-	else
-		cout << "IisuServer::getHandsOpenAmount :: INVALID INDEX" << endl ;
-
 	SK::Array<Vector2> args ; 
+	assignIisuArray( args , getHandFingerTips2DView( handID ) ) ; 
 	return args ; 
 }
\ No newline at end of file
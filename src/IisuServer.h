@@ -15,6 +15,138 @@ using namespace std;
 #include "ofMain.h" 
 #include "IisuUtils.h"
 #include "IisuEvents.h" 
+#include "IisuFrame.h"
+#include "IisuFrameSource.h"
+#include "IisuRecording.h"
+#include "IisuTripleBuffer.h"
+#include "IisuAllocationCounter.h"
+#include "IisuProfiler.h"
+#include "IisuFrameTracker.h"
+#include "IisuKeyPointPredictor.h"
+#include "IisuParameters.h"
+
+//How frames from an IisuFrameSource are pushed through the server
+enum IisuReplayMode
+{
+	IISU_REPLAY_NATIVE_RATE = 0,			//paced by the recorded timestamps, on a background thread
+	IISU_REPLAY_AS_FAST_AS_POSSIBLE = 1,	//no pacing, on a background thread
+	IISU_REPLAY_MANUAL = 2					//nothing runs until stepReplay() is called
+};
+
+//Who drives Device::updateFrame on the live device
+enum IisuAcquisitionMode
+{
+	IISU_ACQUIRE_ON_DATA_FRAME = 0,			//inside iisu's DEVICE.DataFrame callback , like before
+	IISU_ACQUIRE_THREAD = 1					//our own thread blocks in updateFrame( true ) , duplicate frames are never captured
+};
+
+class IisuServer ; 
+
+//Upper bound for IisuServer::maxUsers
+#define IISU_MAX_USERS 8
+
+//What consumers can ask IisuServer to read from iisu every frame , see IisuServer::subscribe()
+enum IisuStream
+{
+	IISU_STREAM_NONE = 0 ,
+	IISU_STREAM_SKELETON = 1 ,			//USER#.SKELETON key points + confidence. Status , scene ID and mass center are always read
+	IISU_STREAM_CENTROIDS = 2 ,			//USER1.SHAPE.CENTROIDS positions + jump status
+	IISU_STREAM_LABEL_IMAGE = 4 ,		//SCENE.LabelImage
+	IISU_STREAM_CONTROLLERS = 8 ,		//UI.CONTROLLER#
+	IISU_STREAM_HANDS = 16 ,			//CI.HAND#
+	IISU_STREAM_ALL = 31
+};
+#define IISU_NUM_STREAMS 5
+
+//Handles for one USER# , registered once and switched on / off with setAutoUpdate as users come and go
+struct IisuUserHandles
+{
+	DataHandle<int32_t>						sceneID ; 
+	DataHandle<SK::Vector3>					massCenter ; 
+	DataHandle<int>							skeletonStatus ; 
+	DataHandle<SK::Array<SK::Vector3> >		keyPoints ; 
+	DataHandle<SK::Array<float> >			keyPointsConfidence ; 
+
+	//Key points only when somebody subscribed to IISU_STREAM_SKELETON
+	void setAutoUpdate( bool bAutoUpdate , bool bSkeleton ) 
+	{
+		sceneID.setAutoUpdate( bAutoUpdate ) ; 
+		massCenter.setAutoUpdate( bAutoUpdate ) ; 
+		skeletonStatus.setAutoUpdate( bAutoUpdate ) ; 
+		keyPoints.setAutoUpdate( bAutoUpdate && bSkeleton ) ; 
+		keyPointsConfidence.setAutoUpdate( bAutoUpdate && bSkeleton ) ; 
+	}
+};
+
+//Handles for one UI.CONTROLLER# / CI.HAND# , generated from IisuSchema.h. Registered switched off , see applyStreams()
+IISU_SCHEMA_HANDLES( IisuControllerHandles , IisuControllerFrame , IISU_CONTROLLER_PATH , IISU_CONTROLLER_FIELDS )
+IISU_SCHEMA_HANDLES( IisuHandHandles , IisuHandFrame , IISU_HAND_PATH , IISU_HAND_FIELDS )
+
+class IisuReplayThread : public ofThread
+{
+	public :
+		IisuReplayThread( ) 
+		{
+			iisu = NULL ; 
+			bNativeRate = true ; 
+		}
+
+		IisuServer * iisu ; 
+		bool bNativeRate ; 
+
+	protected :
+		void threadedFunction( ) ; 
+};
+
+//Waits on iisu for each new frame , locks it , copies it out and releases it again.
+//Keeps the interval between frames for pacing
+class IisuAcquisitionThread : public ofThread
+{
+	public :
+		IisuAcquisitionThread( ) 
+		{
+			iisu = NULL ; 
+			timeoutMillis = 100 ; 
+			bHighPriority = true ; 
+			affinityMask = 0 ; 
+			reset( ) ; 
+		}
+
+		IisuServer * iisu ; 
+		unsigned int timeoutMillis ;		//per updateFrame , also how long stopping the thread can take
+		bool bHighPriority ;				//set before startThread , Windows only
+		unsigned long affinityMask ;		//0 leaves the thread on any core , Windows only
+
+		void reset( ) 
+		{
+			numFrames = 0 ; 
+			numTimeouts = 0 ; 
+			numDuplicates = 0 ; 
+			lastFrameID = -1 ; 
+			lastFrameMicros = 0 ; 
+			lastIntervalMicros = 0.0f ; 
+			averageIntervalMicros = 0.0f ; 
+		}
+
+		int getNumFrames( ) { return iisuAtomicLoad( &numFrames ) ; } 
+		int getNumTimeouts( ) { return iisuAtomicLoad( &numTimeouts ) ; } 
+		int getNumDuplicates( ) { return iisuAtomicLoad( &numDuplicates ) ; } 
+		float getLastIntervalMicros( ) { return lastIntervalMicros ; } 
+		float getAverageIntervalMicros( ) { return averageIntervalMicros ; } 
+		float getFrameRate( ) { return ( averageIntervalMicros > 0.0f ) ? 1000000.0f / averageIntervalMicros : 0.0f ; } 
+
+	protected :
+		void threadedFunction( ) ; 
+		void trackInterval( ) ; 
+
+		iisu_atomic_t numFrames ; 
+		iisu_atomic_t numTimeouts ; 
+		iisu_atomic_t numDuplicates ; 
+		int32_t lastFrameID ; 
+		unsigned long long lastFrameMicros ; 
+		float lastIntervalMicros ; 
+		float averageIntervalMicros ;		//exponential moving average
+};
 
 class IisuServer 
 {
@@ -24,6 +156,43 @@ class IisuServer
 			//Explicity set to NULL before initialization
 			m_iisuHandle = NULL ; 
 			m_device = NULL ; 
+			frameSource = NULL ; 
+			m_lastFrameID = -1 ; 
+			latestFrameID = -1 ; 
+			last_skeletonStatus = 0 ; 
+			lastFrameAllocations = 0 ; 
+			numAllocatingFrames = 0 ; 
+			numCapturedFrames = 0 ; 
+			maxUsers = 4 ; 
+			acquisitionMode = IISU_ACQUIRE_ON_DATA_FRAME ; 
+			for ( int i = 0 ; i < IISU_MAX_USERS ; i++ ) 
+			{
+				userRequested[i] = 0 ; 
+				userApplied[i] = 0 ; 
+			}
+			for ( int i = 0 ; i < IISU_NUM_STREAMS ; i++ ) 
+				streamSubscribers[i] = 0 ; 
+			streamsApplied = IISU_STREAM_NONE ; 
+			numControllersApplied = 0 ; 
+			numHandsApplied = 0 ; 
+			numControllersPublished = 0 ; 
+			numHandsPublished = 0 ; 
+			bRecordingStreams = false ; 
+			bReplayClockSet = false ; 
+			replayFirstRecorded = 0.0 ; 
+			replayFirstApp = 0.0 ; 
+			m_CI_Enabled = false ; 
+			bIisuInitialized = false ; 
+			startupProfile = "" ; 
+			m_centroidCountParameter = &parameters.getInt( "SHAPE.CENTROIDS.Count" ) ; 
+
+			//Never reallocated , iisu's frame thread walks the handles while addController() may still be called.
+			//It goes by numControllersPublished / numHandsPublished , never by size()
+			controllerHandles.reserve( IISU_MAX_CONTROLLERS ) ; 
+			controllers.reserve( IISU_MAX_CONTROLLERS ) ; 
+			lastControllerActive.reserve( IISU_MAX_CONTROLLERS ) ; 
+			handHandles.reserve( IISU_MAX_HANDS ) ; 
+			hands.reserve( IISU_MAX_HANDS ) ; 
 		}
 
 
@@ -38,11 +207,8 @@ class IisuServer
 		DataHandle<bool>						m_userIsActiveData ; 
 		DataHandle < int32_t >					m_user1SceneID ; 
 
-		//UI Pointers
-		vector<DataHandle<bool>>				controllerIsActiveData ; 
-		vector<DataHandle<SK::Vector3>>			pointerNormalizedCoordinatesData ; 
-		vector<DataHandle<int32_t>>				pointerStatusData ; 
-		vector<DataHandle<SK::Vector3>>			pointerGlobalCoordinatesData ; 
+		//UI Pointers , one entry per addController()
+		vector<IisuControllerHandles>			controllerHandles ; 
 		
 		//Camera
 		DataHandle< SK::Image >					sceneImageHandle ;
@@ -52,7 +218,7 @@ class IisuServer
 		SK::DataHandle<SK::Array<SK::Vector3> >	m_keyPointsData;
 		SK::DataHandle<SK::Array<float> >		m_keyPointsConfidenceData;
 
-		ParameterHandle<int32_t>				m_centroidCountParameter ; 
+		IisuParameter<int32_t> *				m_centroidCountParameter ;		//in parameters , cached
 		DataHandle<SK::Array<SK::Vector3>>		m_centroidPositionsData ; 
 		DataHandle< SK::Array<int> >			m_centroidsJumpStatusHandle ;
 		
@@ -63,52 +229,93 @@ class IisuServer
 		int32_t									m_lastFrameID;		//ID of the last Frame
 		bool									m_userIsActive ;
 
-		//UI Pointers
-		vector<bool>							controllerIsActive ; 
-		vector<int32_t>							pointerStatus ; 
-		vector<Vector3>							pointerNormalizedCoordinates ; 
-		vector<Vector3>							pointerGlobalCoordinates ; 
+		//UI Pointers , the last values every added controller had
+		vector<IisuControllerFrame>				controllers ; 
+		vector<unsigned char>					lastControllerActive ;		//iisu's frame thread , see postFrameEvents()
 	
 		//Skeleton + Volume
 		int32_t									m_skeletonStatus ; 
 		SK::Array<SK::Vector3>					m_keyPoints ;
 		SK::Array<float>						m_keyPointsConfidence;
-		int32_t									last_skeletonStatus ;
+		int32_t									last_skeletonStatus ;		//iisu's frame thread , see postFrameEvents()
 		int32_t									m_centroidCount ; 
 		SK::Array<SK::Vector3>					m_centroidPositions ; 
 		SK::Array<int>							m_centroidJumpStatus ; 
 
-		//Camera
-		SK::Image								sceneImage ; 
+		//Multi user , USER1 .. USER<maxUsers>. USER1 ( user 0 ) is always read like before , the others only
+		//between iisu's UM.UserActivated and UM.UserDeactivated for them. Set maxUsers before setup()
+		int										maxUsers ; 
+		vector<IisuUserHandles>					userHandles ; 
+		iisu_atomic_t							userRequested[ IISU_MAX_USERS ] ;	//set from iisu's user events
+		int										userApplied[ IISU_MAX_USERS ] ;		//0 off , 1 on , 2 on with key points. iisu's frame thread only
+		vector<unsigned char>					lastUserActive ; 
+
+		void onUserActivated( SK::UserActivatedEvent event ) ; 
+		void onUserDeactivated( SK::UserDeactivatedEvent event ) ; 
+		void captureUsers( IisuFrame &frame ) ; 
+
+		//Per user data of the current frame , user is 0 based ( USER1 = 0 )
+		int getMaxUsers( ) { return maxUsers ; } 
+		const vector<int>& getActiveUsers( ) const { return getFrame().activeUsers ; } 
+		bool isUserActive( int user ) ; 
+		int getUserSkeletonStatus( int user ) ; 
+		int getUserSceneID( int user ) ; 
+		Vector3 getUserMassCenter( int user ) ; 
+		const Vector3 * getUserKeyPoints( int user ) ;				//IISU_NUM_JOINTS points , NULL if the user isn't there
+		const float * getUserKeyPointsConfidence( int user ) ; 
+
+		//Key points extrapolated to targetTime ( seconds on the ofGetElapsedTimef() clock , like IisuFrame::timestamp ) ,
+		//e.g. ofGetElapsedTimef() + one or two display frames. NULL if the user isn't tracked , see IisuKeyPointPredictor
+		const Vector3 * getPredictedKeyPoints( double targetTime , int user = 0 ) ; 
+		IisuKeyPointPredictor					keyPointPredictors[ IISU_MAX_USERS ] ; 
+
+		//Only streams somebody subscribed to are read from iisu , the handles of the others are switched off.
+		//Counted per stream , every subscribe() needs its unsubscribe(). IisuSkeleton , IisuUserRepresentation ,
+		//DepthCursor , HandCursor and IisuGestureRecognizer subscribe themselves. Replayed frames always have everything
+		void subscribe( int streams ) ; 
+		void unsubscribe( int streams ) ; 
+		int getSubscribedStreams( ) ; 
+
+		iisu_atomic_t							streamSubscribers[ IISU_NUM_STREAMS ] ; 
+		int										streamsApplied ;		//auto update state , iisu's frame thread only , applied before each updateFrame
+		int										numControllersApplied ;		//iisu's frame thread , what captureFrame() reads
+		int										numHandsApplied ; 
+		iisu_atomic_t							numControllersPublished ;	//bumped by addController() once the entry is complete
+		iisu_atomic_t							numHandsPublished ;			//same for addCloseInteractionHand()
+		void applyStreams( ) ; 
+
+		//Cached parameters and named profiles. initIisu() applies "default" and then startupProfile ( set it before setup() ) ,
+		//parameters.apply( "low-power" ) and the like work any time after , parameters.getLastApply() has what it cost
+		IisuParameters							parameters ; 
+		string									startupProfile ; 
+
+		//Camera , SCENE.LabelImage one byte per pixel lives in getFrame().labelImage
+		bool hasSceneImage( ) { return ( getFrame().labelImage.size() > 0 ) ; } 
 	
 		//Two modes for the camera close / far
 		bool bCloseInteraction ;		
 
 		//Close Range Interaction
-		ParameterHandle<bool>						m_CI_EnabledHandle ; 
-
-		vector<DataHandle<int32_t>>					handStatusesHandle ; 
-		vector<DataHandle<Vector2>>					handPalmPositions2DHandle ;
-		vector<DataHandle<Vector2>>					handTipPositions2DHandle ; 
-		vector<DataHandle<SK::Array<Vector2>>>		handFingerTips2DHandle ;
-		vector<DataHandle<SK::Array<int32_t>>>		handFingerTipsStatusHandle ; 
-		vector<DataHandle<bool>>					handsOpenHandle ; 
-		vector<DataHandle<float>>					handsOpenAmountHandle ; 
 
+		//One entry per addCloseInteractionHand() , handles and the last values
+		vector<IisuHandHandles>						handHandles ; 
 		int numHands ; 
-		vector<int32_t>								handStatuses; 
-		vector<Vector2>								handPalmPositions2D ;
-		vector<Vector2>								handTipPositions2D; 
-		vector<SK::Array<Vector2>>					handFingerTips2D ;
-		vector<SK::Array<int32_t>>					handFingerTipsStatus ; 
-		vector<bool>								handsOpen ; 
-		vector<float>								handsOpenAmount ; 					
+		vector<IisuHandFrame>						hands ; 
 
 		int getHandStatus ( int handID ) ; 
 		Vector2 getHandPalmPosition2D ( int handID ) ; 
 		Vector2 getHandTipPosition2D( int handID ) ; 
 		bool getHandsOpen( int handID ) ; 
 		float getHandsOpenAmount ( int handID ) ; 
+
+		//Straight into the current frame , no copy , good until the next update(). Empty for an unknown hand
+		IisuArrayView<int32_t> getHandFingerTipsStatusView( int handID ) ; 
+		IisuArrayView<Vector2> getHandFingerTips2DView( int handID ) ; 
+		IisuArrayView<Vector3> getKeyPointsView( ) { return IisuArrayView<Vector3>( getFrame().keyPoints ) ; } 
+		IisuArrayView<float> getKeyPointsConfidenceView( ) { return IisuArrayView<float>( getFrame().keyPointsConfidence ) ; } 
+		IisuArrayView<Vector3> getCentroidPositionsView( ) { return IisuArrayView<Vector3>( getFrame().centroidPositions ) ; } 
+
+		//Copies of the views above , a new SK::Array every call
 		SK::Array<int32_t> getHandsFingerTipsStatus ( int handID ) ;
 		SK::Array<Vector2> getHandsFingerTips2D ( int handID ) ;
 
@@ -121,14 +328,91 @@ class IisuServer
 		// events callbacks
 		void onError(const ErrorEvent& event);
 		void onDataFrame(const DataFrameEvent& event)	; 
+		void acquireFrame( unsigned long long deliveredMicros ) ;		//capture + release + publish the frame updateFrame just fetched
 		void registerEvents() ; 
 
 		void setup( bool _bCloseInteraction ) ; 
+		//Replay frames from a source instead of a camera, no iisu handle or device is created
+		void setup( IisuFrameSource * source , bool _bCloseInteraction , IisuReplayMode replayMode = IISU_REPLAY_NATIVE_RATE ) ; 
+		//setup() calls it , later calls do nothing : the frame thread is already reading the handles it registers
 		void initIisu() ; 
+		bool									bIisuInitialized ; 
+
+		//Set before setup() , see IisuAcquisitionMode
+		IisuAcquisitionMode						acquisitionMode ; 
+		IisuAcquisitionThread					acquisitionThread ; 
+
+		//Call once per app update() , picks up the newest frame iisu published and refreshes the members above.
+		//Never blocks on the iisu thread. Returns false if no new frame came in since the last call
+		bool update( ) ; 
+
+		//The frame update() picked up , it stays untouched until the next update()
+		const IisuFrame& getFrame( ) const { return frameBuffer.getReadBuffer() ; } 
+
+		//iisu's thread fills the write side of the triple buffer , the app thread reads the other end
+		IisuTripleBuffer<IisuFrame>				frameBuffer ; 
+		void captureFrame( IisuFrame &frame ) ; 
+		void publishFrame( ) ; 
+		void postFrameEvents( const IisuFrame &frame ) ;	//user and cursor transitions into IisuEvents' deferred queue
+		void processFrame( const IisuFrame &frame ) ; 
+		iisu_atomic_t							latestFrameID ;		//last frame published , stamps iisu's own events
+		void preallocateFrames( ) ; 
+
+		//Heap allocations made while capturing + publishing on iisu's thread , only counted
+		//when built with IISU_COUNT_ALLOCATIONS. After the first few frames both should stay at 0
+		int getLastFrameAllocations( ) { return lastFrameAllocations ; } 
+		int getNumAllocatingFrames( ) { return iisuAtomicLoad( &numAllocatingFrames ) ; } 
+		int getNumCapturedFrames( ) { return iisuAtomicLoad( &numCapturedFrames ) ; } 
+		//Frame ID gaps , duplicates , jitter and stalls , see IisuFrameTracker
+		IisuFrameStats getFrameStats( ) { return frameTracker.getStats( ) ; } 
+		IisuFrameTracker						frameTracker ; 
+
+		void resetAllocationCount( ) 
+		{
+			iisuAtomicStore( &numAllocatingFrames , 0 ) ; 
+			iisuAtomicStore( &numCapturedFrames , 0 ) ; 
+		}
+		int										lastFrameAllocations ; 
+		iisu_atomic_t							numAllocatingFrames ; 
+		iisu_atomic_t							numCapturedFrames ; 
+
+		//Replay
+		bool isReplaying( ) { return ( frameSource != NULL ) ; } 
+		bool stepReplay( ) ;					//read + process one frame from the source on the calling thread
+		void stopReplay( ) ; 
+		IisuFrameSource *						frameSource ; 
+		IisuReplayThread						replayThread ; 
+
+		//Replayed timestamps are moved onto the ofGetElapsedTimef() clock like live ones : the first frame lands
+		//on the app time it was read at , the others keep their recorded distance to it
+		void rebaseReplayFrame( IisuFrame &frame ) ; 
+		double									replayFirstRecorded ; 
+		double									replayFirstApp ; 
+		bool									bReplayClockSet ; 
+
+		//Recording , every published frame is appended to the file until stopRecording().
+		//Subscribes to every stream while it runs so the file has everything a replay could need
+		bool startRecording( string path ) ; 
+		void stopRecording( ) ; 
+		bool isRecording( ) { return recorder.isRecording( ) ; } 
+		IisuRecorder							recorder ; 
+		bool									bRecordingStreams ; 
+
+		template<typename T> 
+		DataHandle<T> registerData( const string &path , bool bAutoUpdate = true ) 
+		{
+			//Replaying, keep the handle vectors in step with the values but don't touch iisu
+			if ( m_device == NULL ) 
+				return DataHandle<T>( ) ; 
+
+			return m_device->registerDataHandle<T>( path.c_str() , bAutoUpdate ) ; 
+		}
+
 		int addController( ) ;
 		int addCloseInteractionHand ( ) ;
 		void exit( int exitCode = -1 ) ; 
 		void onControllerCreated(SK::ControllerCreationEvent event);
+		void onControllerDestroyed(SK::ControllerDestructionEvent event);
 		void onCircleGesture(SK::CircleGestureEvent event);
 
 		int getCursorStatus ( int cursorID ) ; 
@@ -136,4 +420,39 @@ class IisuServer
 		Vector3 getWorldCursorPosition( int cursorID ) ; 
 };
 
+//A consumer's streams on one server. Released when it goes away or points at another server ,
+//a copy starts out empty and subscribes on its own
+class IisuSubscription
+{
+	public :
+		IisuSubscription( ) { server = NULL ; streams = IISU_STREAM_NONE ; } 
+		IisuSubscription( const IisuSubscription &other ) { server = NULL ; streams = IISU_STREAM_NONE ; } 
+		IisuSubscription& operator=( const IisuSubscription &other ) { release( ) ; return *this ; } 
+		~IisuSubscription( ) { release( ) ; } 
+
+		//Cheap when nothing changed , fine to call every update()
+		void set( IisuServer * _server , int _streams ) 
+		{
+			if ( _server == server && _streams == streams ) 
+				return ; 
+			release( ) ; 
+			server = _server ; 
+			streams = _streams ; 
+			if ( server != NULL ) 
+				server->subscribe( streams ) ; 
+		}
 
+		void release( ) 
+		{
+			if ( server != NULL ) 
+				server->unsubscribe( streams ) ; 
+			server = NULL ; 
+			streams = IISU_STREAM_NONE ; 
+		}
+
+		int getStreams( ) { return streams ; } 
+
+	protected :
+		IisuServer * server ; 
+		int streams ; 
+};
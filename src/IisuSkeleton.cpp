@@ -7,6 +7,7 @@ void IisuSkeleton::setup ( )
 	bFlipY = false ;
 	bEqualScaling = false ; 
 	glEnable(GL_DEPTH_TEST);
+	smoother.setup( 3 * IISU_MAX_USERS * IISU_NUM_JOINTS ) ; 
 
 	int totalJoints = 21 ; 
 	for ( int i = 0 ; i < totalJoints ; i++ ) 
@@ -17,32 +18,71 @@ void IisuSkeleton::setup ( )
 }
 
 
+void IisuSkeleton::updateMappers( ) 
+{
+	//iisu is z up , the offset is given in screen order so y + z swap on the way in
+	screenMapper = IisuCoordinateMapper::iisuPosition3DToOfxScreen( bounds , bFlipX , bFlipY ) ; 
+	screenMapper.transform.translateInput( offset.x , offset.z , offset.y ) ; 
+
+	rawMapper.transform.setRow( 0 , bounds.width , 0 , 0 , offset.x ) ; 
+	rawMapper.transform.setRow( 1 , 0 , bounds.height , 0 , offset.y ) ; 
+	rawMapper.transform.setRow( 2 , 0 , 0 , 1 , offset.z ) ; 
+}
+
 void IisuSkeleton::update ( ) 
 {
-	bTracked = iisu->m_skeletonStatus ; 
+	IISU_PROFILE_SCOPE( IISU_STAGE_SKELETON_UPDATE ) ; 
+	subscription.set( iisu , IISU_STREAM_SKELETON ) ; 
+	const Vector3 * keyPoints = iisu->getUserKeyPoints( user ) ; 
+	bTracked = ( user >= 0 && user < IISU_MAX_USERS && iisu->getUserSkeletonStatus( user ) != 0 && keyPoints != NULL ) ; 
 	if ( bTracked != 0 ) 
 	{		
-		SK::Array<SK::Vector3> keyPoints = iisu->m_keyPoints ; 		
-		SK::Array<float> keyPointsConfidence = iisu->m_keyPointsConfidence ; 
+		updateMappers( ) ; 
 
+		//Every user the frame has , in one pass over the packed key points
+		const IisuFrame &frame = iisu->getFrame() ; 
+		int numSlots = ( frame.activeUsers.size() > 0 ) ? frame.activeUsers.back() + 1 : 0 ; 
+		numSlots = MIN( numSlots , IISU_MAX_USERS ) ; 
+		int first = user * IISU_NUM_JOINTS ; 
+		if ( user < numSlots && frame.userActive[ user ] ) 
+		{
+			screenMapper.map( &frame.userKeyPoints[0] , numSlots * IISU_NUM_JOINTS , jointX , jointY , jointZ ) ; 
+			numJointUsers = numSlots ; 
+		}
+		else
+		{
+			//Key points that didn't come from the per user arrays ( older frame sources )
+			screenMapper.map( keyPoints , IISU_NUM_JOINTS , jointX + first , jointY + first , jointZ + first ) ; 
+			numJointUsers = user + 1 ; 
+		}
+		rawMapper.map( keyPoints , IISU_NUM_JOINTS , rawX , rawY , rawZ ) ; 
+
+		//Every user's joints in one pass per axis , users that aren't there start over when they come back
+		int numJoints = numJointUsers * IISU_NUM_JOINTS ; 
+		int axisChannels = IISU_MAX_USERS * IISU_NUM_JOINTS ; 
+		smoother.filter( jointX , 0 , numJoints , frame.timestamp ) ; 
+		smoother.filter( jointY , axisChannels , numJoints , frame.timestamp ) ; 
+		smoother.filter( jointZ , 2 * axisChannels , numJoints , frame.timestamp ) ; 
+		for ( int u = 0 ; u < numJointUsers ; u++ ) 
+		{
+			if ( isJointUserActive( frame , u ) ) 
+				continue ; 
+			for ( int axis = 0 ; axis < 3 ; axis++ ) 
+				smoother.reset( axis * axisChannels + u * IISU_NUM_JOINTS , IISU_NUM_JOINTS ) ; 
+		}
 
-		rawPositions.clear( ) ; 
-		positions.clear( ) ; 
-		for ( int i = 0 ; i < keyPoints.size() ; i++ ) 
+		rawPositions.resize( IISU_NUM_JOINTS ) ; 
+		positions.resize( IISU_NUM_JOINTS ) ; 
+		for ( int i = 0 ; i < IISU_NUM_JOINTS ; i++ ) 
 		{
-			//Use the helper function to get the right coordinate spaces
-			ofPoint _p = ofPoint ( keyPoints[i].x * bounds.width, keyPoints[i].y * bounds.height , keyPoints[i].z ) + offset ; 
-			rawPositions.push_back ( _p ) ;
-			Vector3 keyP = keyPoints[i] ; 
-			keyP.x += offset.x ; 
-			keyP.y += offset.z ; 
-			keyP.z += offset.y ; 
-			ofVec3f _scale = ofVec3f( scale.x , scale.x , scale.x ) ; 
-			ofVec3f p = IisuUtils::Instance()->iisuPosition3DToOfxScreen( keyP , bounds , bFlipX , bFlipY ) ; 
-			positions.push_back( p ) ; 
+			rawPositions[i].set( rawX[i] , rawY[i] , rawZ[i] ) ; 
+			positions[i].set( jointX[ first + i ] , jointY[ first + i ] , jointZ[ first + i ] ) ; 
 		}
 
 		centroid = positions[ SK::SkeletonEnum::WAIST ] ;   
+
+		if ( frame.frameID != lastStoredFrameID ) 
+			storeFrame( frame ) ; 
 	}
 	else
 	{
@@ -50,6 +90,121 @@ void IisuSkeleton::update ( )
 	}
 }
 
+bool IisuSkeleton::isJointUserActive( const IisuFrame &frame , int _user ) 
+{
+	//A user without a skeleton has zeroed rows , those mustn't be smoothed or interpolated towards
+	if ( _user < frame.getNumUserSlots() ) 
+		return ( frame.userActive[ _user ] && frame.userSkeletonStatus[ _user ] != 0 ) ; 
+	return ( _user == user && bTracked ) ; 
+}
+
+void IisuSkeleton::storeFrame( const IisuFrame &frame ) 
+{
+	int older = newestFrame ; 
+	newestFrame = 1 - newestFrame ; 
+	lastStoredFrameID = frame.frameID ; 
+	frameTimes[ newestFrame ] = frame.timestamp ; 
+	numStoredFrames = MIN( numStoredFrames + 1 , 2 ) ; 
+
+	int numJoints = numJointUsers * IISU_NUM_JOINTS ; 
+	memcpy( frameX[ newestFrame ] , jointX , numJoints * sizeof( float ) ) ; 
+	memcpy( frameY[ newestFrame ] , jointY , numJoints * sizeof( float ) ) ; 
+	memcpy( frameZ[ newestFrame ] , jointZ , numJoints * sizeof( float ) ) ; 
+
+	SK::Quaternion * bones = frameBones[ newestFrame ] ; 
+	Vector3 up( 0 , 1 , 0 ) ; 
+	Vector3 fallback( 0 , 0 , 1 ) ; 
+	for ( int u = 0 ; u < IISU_MAX_USERS ; u++ ) 
+	{
+		int first = u * IISU_NUM_JOINTS ; 
+		frameUserActive[ newestFrame ][u] = ( u < numJointUsers && isJointUserActive( frame , u ) ) ; 
+		if ( frameUserActive[ newestFrame ][u] == false ) 
+			continue ; 
+
+		bones[ first ] = SK::Quaternion::IDENTITY ; 
+		for ( int j = 1 ; j < IISU_NUM_JOINTS ; j++ ) 
+		{
+			int i = first + j ; 
+			int parent = first + iisuJointParent( j ) ; 
+			Vector3 bone( jointX[i] - jointX[ parent ] , jointY[i] - jointY[ parent ] , jointZ[i] - jointZ[ parent ] ) ; 
+			bones[i] = SK::Quaternion::GetRotationBetween( up , bone , fallback ) ; 
+		}
+
+		//A user that wasn't in the older frame holds still instead of flying in from wherever that slot was
+		bool bWasThere = ( numStoredFrames == 2 && frameUserActive[ older ][u] ) ; 
+		if ( bWasThere == false ) 
+		{
+			memcpy( frameX[ older ] + first , jointX + first , IISU_NUM_JOINTS * sizeof( float ) ) ; 
+			memcpy( frameY[ older ] + first , jointY + first , IISU_NUM_JOINTS * sizeof( float ) ) ; 
+			memcpy( frameZ[ older ] + first , jointZ + first , IISU_NUM_JOINTS * sizeof( float ) ) ; 
+			for ( int j = 0 ; j < IISU_NUM_JOINTS ; j++ ) 
+				frameBones[ older ][ first + j ] = bones[ first + j ] ; 
+		}
+	}
+	numRenderUsers = numJointUsers ; 
+}
+
+double IisuSkeleton::getInterpolationTime( ) 
+{
+	double now = ofGetElapsedTimef() ; 
+	if ( numStoredFrames < 2 ) 
+		return now ; 
+	return now - ( frameTimes[ newestFrame ] - frameTimes[ 1 - newestFrame ] ) ; 
+}
+
+void IisuSkeleton::interpolate( double renderTime ) 
+{
+	if ( numStoredFrames == 0 ) 
+		return ; 
+
+	int older = ( numStoredFrames == 2 ) ? 1 - newestFrame : newestFrame ; 
+	double span = frameTimes[ newestFrame ] - frameTimes[ older ] ; 
+	float alpha = 1.0f ; 
+	if ( span > 0.0 ) 
+		alpha = ofClamp( (float) ( ( renderTime - frameTimes[ older ] ) / span ) , 0.0f , 1.0f ) ; 
+
+	//Every user in one straight pass per axis
+	int numJoints = numRenderUsers * IISU_NUM_JOINTS ; 
+	const float * x0 = frameX[ older ] ; const float * x1 = frameX[ newestFrame ] ; 
+	const float * y0 = frameY[ older ] ; const float * y1 = frameY[ newestFrame ] ; 
+	const float * z0 = frameZ[ older ] ; const float * z1 = frameZ[ newestFrame ] ; 
+	for ( int i = 0 ; i < numJoints ; i++ ) 
+	{
+		renderX[i] = x0[i] + ( x1[i] - x0[i] ) * alpha ; 
+		renderY[i] = y0[i] + ( y1[i] - y0[i] ) * alpha ; 
+		renderZ[i] = z0[i] + ( z1[i] - z0[i] ) * alpha ; 
+	}
+
+	const SK::Quaternion * q0 = frameBones[ older ] ; 
+	const SK::Quaternion * q1 = frameBones[ newestFrame ] ; 
+	for ( int u = 0 ; u < numRenderUsers ; u++ ) 
+	{
+		if ( frameUserActive[ newestFrame ][u] == false ) 
+			continue ; 
+		int last = ( u + 1 ) * IISU_NUM_JOINTS ; 
+		for ( int i = u * IISU_NUM_JOINTS ; i < last ; i++ ) 
+			renderBones[i] = SK::Quaternion::Slerp( alpha , q0[i] , q1[i] , true ) ; 
+	}
+}
+
+ofPoint IisuSkeleton::getRenderJoint( int _user , int joint ) 
+{
+	if ( _user < 0 || _user >= numRenderUsers || joint < 0 || joint >= IISU_NUM_JOINTS ) 
+		return ofPoint( ) ; 
+
+	int i = _user * IISU_NUM_JOINTS + joint ; 
+	return ofPoint( renderX[i] , renderY[i] , renderZ[i] ) ; 
+}
+
+ofPoint IisuSkeleton::getJoint( int _user , int joint ) 
+{
+	if ( _user < 0 || _user >= numJointUsers || joint < 0 || joint >= IISU_NUM_JOINTS ) 
+		return ofPoint( ) ; 
+
+	int i = _user * IISU_NUM_JOINTS + joint ; 
+	return ofPoint( jointX[i] , jointY[i] , jointZ[i] ) ; 
+}
+
 void IisuSkeleton::draw ( ) 
 {
 
@@ -57,12 +212,16 @@ void IisuSkeleton::draw ( )
 
 	if ( bTracked != false ) 
 	{		
+		//Blended for this draw() , so the joints move at the display's rate and not iisu's
+		if ( bInterpolate ) 
+			interpolate( getInterpolationTime() ) ; 
+
 		ofSetColor ( ofColor::red ) ; 
 		for ( int i = 0 ; i < positions.size() ; i++ ) 
 		{
-			//Use the helper function to get the right coordinate spaces
+			ofPoint joint = bInterpolate ? getRenderJoint( user , i ) : positions[i] ; 
 			ofPushMatrix() ; 
-				ofTranslate( positions[i].x , positions[i].y , positions[i].z ) ; 
+				ofTranslate( joint.x , joint.y , joint.z ) ; 
 				ofSetColor( jointColors[ i ] ) ; 
 				ofSphere( 0 , 0 , 0, jointSizes[ i ] ) ; 
 			ofPopMatrix() ; 
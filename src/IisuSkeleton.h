@@ -12,16 +12,28 @@ Base
 #include "ofMain.h"
 #include "IisuServer.h"
 #include "IisuUtils.h"
+#include "IisuFilter.h"
 
 
 class IisuSkeleton
 {
 	public : 
 
-		IisuSkeleton ( ) { } 
+		IisuSkeleton ( ) 
+		{
+			user = 0 ; 
+			numJointUsers = 0 ; 
+			numRenderUsers = 0 ; 
+			numStoredFrames = 0 ; 
+			newestFrame = 0 ; 
+			lastStoredFrameID = -1 ; 
+			bInterpolate = true ; 
+		}
 		~IisuSkeleton ( ) { } 
 
 		IisuServer * iisu ; 
+		IisuSubscription subscription ;		//key points , taken in update()
+		int user ;				//which USER# this skeleton follows , 0 based
 
 		bool	m_userManagementEnabled;
 
@@ -44,6 +56,53 @@ class IisuSkeleton
 		vector<ofPoint> rawPositions ;		//RAW iisu positions ( y + Z are switched ) they are in meters from the world center 
 											//the world center is wherever you calibrated your t-stance post in playzone setup
 		vector<ofPoint> positions ;			//offset + scaled positions , y + z back to normal
+
+		//Screen space joints of every active user , filled in one batch by update().
+		//Structure of arrays , joint j of user u is at [ u * IISU_NUM_JOINTS + j ]
+		float jointX[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		float jointY[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		float jointZ[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		int numJointUsers ;					//user slots covered by the joint arrays
+		ofPoint getJoint( int _user , int joint ) ; 
+
+		//Runs over the joint arrays above in screen units , x channels first then y then z. One Euro by default ,
+		//set smoother.settings.type to IISU_FILTER_NONE for the raw joints
+		IisuFilterBank smoother ; 
+
+		//Render rate joints. update() keeps the joint arrays of the last two iisu frames , interpolate() blends them
+		//for renderTime ( seconds , IisuFrame::timestamp clock ) in one pass over every user. Pass
+		//getInterpolationTime() , one camera frame behind , and the result always sits between two real frames
+		void interpolate( double renderTime ) ; 
+		double getInterpolationTime( ) ; 
+		float renderX[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		float renderY[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		float renderZ[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		SK::Quaternion renderBones[ IISU_MAX_USERS * IISU_NUM_JOINTS ] ;		//+y turned onto parent -> joint , identity for the pelvis
+		int numRenderUsers ; 
+		ofPoint getRenderJoint( int _user , int joint ) ; 
+		bool bInterpolate ;			//draw() interpolates and draws the render joints , false draws positions as they came in
+
+		//bounds , offset and flips folded into one matrix each , rebuilt every update()
+		IisuCoordinateMapper screenMapper ; 
+		IisuCoordinateMapper rawMapper ; 
+		void updateMappers( ) ; 
+
+	protected :
+		void storeFrame( const IisuFrame &frame ) ; 
+		bool isJointUserActive( const IisuFrame &frame , int _user ) ; 
+
+		//The two frames interpolate() blends , newestFrame is the index of the latest
+		float frameX[2][ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		float frameY[2][ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		float frameZ[2][ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		SK::Quaternion frameBones[2][ IISU_MAX_USERS * IISU_NUM_JOINTS ] ; 
+		bool frameUserActive[2][ IISU_MAX_USERS ] ; 
+		double frameTimes[2] ; 
+		int numStoredFrames ; 
+		int newestFrame ; 
+		int lastStoredFrameID ; 
+
+		float rawX[ IISU_NUM_JOINTS ] , rawY[ IISU_NUM_JOINTS ] , rawZ[ IISU_NUM_JOINTS ] ; 
 		vector<float> jointSizes ;			
 		vector<ofColor> jointColors ;
 };
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+	IisuTripleBuffer
+	Single writer / single reader hand off that never blocks either side.
+	The writer fills getWriteBuffer() and publish()es it , the reader calls update() whenever it wants the
+	newest value and then reads getReadBuffer() which nobody else touches until its next update().
+	Frames published while the reader wasn't looking are simply replaced by newer ones.
+*/
+
+#include "IisuAtomic.h"
+
+template<typename T>
+class IisuTripleBuffer
+{
+	public :
+		IisuTripleBuffer( ) 
+		{
+			writeIndex = 0 ; 
+			readIndex = 1 ; 
+			middle = 2 ; 
+		}
+
+		//Writer side
+		T& getWriteBuffer( ) { return buffers[ writeIndex ] ; } 
+
+		void publish( ) 
+		{
+			//Hand our buffer over , flagged as fresh , and take whatever sat in the middle
+			long previous = iisuAtomicExchange( &middle , writeIndex | FRESH ) ; 
+			writeIndex = previous & INDEX_MASK ; 
+		}
+
+		//Reader side , returns false when nothing new was published since the last call
+		bool update( ) 
+		{
+			if ( ( iisuAtomicLoad( &middle ) & FRESH ) == 0 ) 
+				return false ; 
+
+			long previous = iisuAtomicExchange( &middle , readIndex ) ; 
+			readIndex = previous & INDEX_MASK ; 
+			return true ; 
+		}
+
+		const T& getReadBuffer( ) const { return buffers[ readIndex ] ; } 
+
+		//All three buffers , only safe to touch before the writer and reader start
+		T& getBuffer( int i ) { return buffers[ i ] ; } 
+
+	protected :
+		enum { INDEX_MASK = 3 , FRESH = 4 } ; 
+
+		T buffers[3] ; 
+		int writeIndex ;				//only touched by the writer
+		int readIndex ;					//only touched by the reader
+		iisu_atomic_t middle ;			//index of the spare buffer + FRESH bit
+};
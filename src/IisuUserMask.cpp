@@ -0,0 +1,225 @@
+#include "IisuUserMask.h"
+#include <string.h>
+
+#ifdef IISU_X86
+#include <emmintrin.h>
+#endif
+#ifdef IISU_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Index of the lowest / highest set bit , bits is never 0
+static inline int lowestBit( unsigned int bits ) 
+{
+#ifdef _MSC_VER
+	unsigned long index ; 
+	_BitScanForward( &index , bits ) ; 
+	return (int) index ; 
+#else
+	return __builtin_ctz( bits ) ; 
+#endif
+}
+
+static inline int highestBit( unsigned int bits ) 
+{
+#ifdef _MSC_VER
+	unsigned long index ; 
+	_BitScanReverse( &index , bits ) ; 
+	return (int) index ; 
+#else
+	return 31 - __builtin_clz( bits ) ; 
+#endif
+}
+
+//Plain bit twiddling , POPCNT isn't guaranteed on SSE2 machines
+static inline int countBits( unsigned int bits ) 
+{
+	bits = bits - ( ( bits >> 1 ) & 0x55555555 ) ; 
+	bits = ( bits & 0x33333333 ) + ( ( bits >> 2 ) & 0x33333333 ) ; 
+	return (int) ( ( ( ( bits + ( bits >> 4 ) ) & 0x0f0f0f0f ) * 0x01010101 ) >> 24 ) ; 
+}
+
+//Four histograms side by side so neighbouring pixels with the same label don't wait on each other's increment
+struct IisuLabelHistogram
+{
+	unsigned int counts[4][256] ; 
+
+	IisuLabelHistogram( ) { memset( counts , 0 , sizeof( counts ) ) ; } 
+
+	inline void add( const unsigned char * labels , int count ) 
+	{
+		int i = 0 ; 
+		for ( ; i + 4 <= count ; i += 4 ) 
+		{
+			counts[0][ labels[i] ]++ ; 
+			counts[1][ labels[i + 1] ]++ ; 
+			counts[2][ labels[i + 2] ]++ ; 
+			counts[3][ labels[i + 3] ]++ ; 
+		}
+		for ( ; i < count ; i++ ) 
+			counts[0][ labels[i] ]++ ; 
+	}
+
+	void merge( unsigned int * histogram ) 
+	{
+		for ( int i = 0 ; i < 256 ; i++ ) 
+			histogram[i] = counts[0][i] + counts[1][i] + counts[2][i] + counts[3][i] ; 
+	}
+};
+
+//Row bookkeeping shared by all paths
+struct IisuMaskBounds
+{
+	int minX , maxX ; 
+
+	IisuMaskBounds( ) { minX = 0x7fffffff ; maxX = -1 ; } 
+
+	inline void addBits( int x , unsigned int bits ) 
+	{
+		int first = x + lowestBit( bits ) ; 
+		int last = x + highestBit( bits ) ; 
+		if ( first < minX ) minX = first ; 
+		if ( last > maxX ) maxX = last ; 
+	}
+};
+
+//Handles the tail of a row ( and whole rows for the scalar path ). Returns the number of user pixels
+static inline int extractScalar( const unsigned char * labels , unsigned char * mask , int x0 , int x1 , 
+								 unsigned char userID , unsigned char previousUserID , unsigned char enable , IisuMaskBounds &bounds ) 
+{
+	int numUser = 0 ; 
+	for ( int x = x0 ; x < x1 ; x++ ) 
+	{
+		unsigned char value = labels[x] ; 
+		unsigned char m = (unsigned char) ( ( ( value == userID ) | ( value == previousUserID ) ) ? enable : 0 ) ; 
+		mask[x] = m ; 
+		if ( m ) 
+		{
+			numUser++ ; 
+			if ( x < bounds.minX ) bounds.minX = x ; 
+			if ( x > bounds.maxX ) bounds.maxX = x ; 
+		}
+	}
+	return numUser ; 
+}
+
+#ifdef IISU_X86
+static int extractRowSSE2( const unsigned char * labels , unsigned char * mask , int width , 
+						   unsigned char userID , unsigned char previousUserID , unsigned char enable , IisuMaskBounds &bounds ) 
+{
+	__m128i user = _mm_set1_epi8( (char) userID ) ; 
+	__m128i previous = _mm_set1_epi8( (char) previousUserID ) ; 
+	__m128i enabled = _mm_set1_epi8( (char) enable ) ; 
+
+	int numUser = 0 ; 
+	int x = 0 ; 
+	for ( ; x + 16 <= width ; x += 16 ) 
+	{
+		__m128i value = _mm_loadu_si128( (const __m128i *) ( labels + x ) ) ; 
+		__m128i m = _mm_or_si128( _mm_cmpeq_epi8( value , user ) , _mm_cmpeq_epi8( value , previous ) ) ; 
+		m = _mm_and_si128( m , enabled ) ; 
+		_mm_storeu_si128( (__m128i *) ( mask + x ) , m ) ; 
+
+		unsigned int bits = (unsigned int) _mm_movemask_epi8( m ) ; 
+		if ( bits ) 
+		{
+			numUser += countBits( bits ) ; 
+			bounds.addBits( x , bits ) ; 
+		}
+	}
+	return numUser + extractScalar( labels , mask , x , width , userID , previousUserID , enable , bounds ) ; 
+}
+#endif
+
+#ifdef IISU_HAS_AVX2_KERNELS
+IISU_TARGET_AVX2 static int extractRowAVX2( const unsigned char * labels , unsigned char * mask , int width , 
+											unsigned char userID , unsigned char previousUserID , unsigned char enable , IisuMaskBounds &bounds ) 
+{
+	__m256i user = _mm256_set1_epi8( (char) userID ) ; 
+	__m256i previous = _mm256_set1_epi8( (char) previousUserID ) ; 
+	__m256i enabled = _mm256_set1_epi8( (char) enable ) ; 
+
+	int numUser = 0 ; 
+	int x = 0 ; 
+	for ( ; x + 32 <= width ; x += 32 ) 
+	{
+		__m256i value = _mm256_loadu_si256( (const __m256i *) ( labels + x ) ) ; 
+		__m256i m = _mm256_or_si256( _mm256_cmpeq_epi8( value , user ) , _mm256_cmpeq_epi8( value , previous ) ) ; 
+		m = _mm256_and_si256( m , enabled ) ; 
+		_mm256_storeu_si256( (__m256i *) ( mask + x ) , m ) ; 
+
+		unsigned int bits = (unsigned int) _mm256_movemask_epi8( m ) ; 
+		if ( bits ) 
+		{
+			numUser += countBits( bits ) ; 
+			bounds.addBits( x , bits ) ; 
+		}
+	}
+	return numUser + extractScalar( labels , mask , x , width , userID , previousUserID , enable , bounds ) ; 
+}
+#endif
+
+void IisuUserMask::extract( const unsigned char * labels , int width , int height , int userID , int previousUserID , 
+							unsigned char * mask , IisuUserMaskResult &result , IisuSimdLevel level ) 
+{
+	result.clear( ) ; 
+	if ( labels == NULL || mask == NULL || width <= 0 || height <= 0 ) 
+		return ; 
+
+	//The level asked for might be more than this machine has
+	if ( level > IisuCpu::getSimdLevel() ) 
+		level = IisuCpu::getSimdLevel() ; 
+
+	unsigned char enable = (unsigned char) ( userID < 250 ? 255 : 0 ) ; 
+	unsigned char user = (unsigned char) userID ; 
+	unsigned char previous = (unsigned char) previousUserID ; 
+
+	IisuLabelHistogram histogram ; 
+	for ( int y = 0 ; y < height ; y++ ) 
+	{
+		const unsigned char * row = labels + y * width ; 
+		unsigned char * maskRow = mask + y * width ; 
+
+		IisuMaskBounds bounds ; 
+		int numUser = 0 ; 
+		switch ( level ) 
+		{
+#ifdef IISU_HAS_AVX2_KERNELS
+			case IISU_SIMD_AVX2 : 
+				numUser = extractRowAVX2( row , maskRow , width , user , previous , enable , bounds ) ; 
+				break ; 
+#endif
+#ifdef IISU_X86
+			case IISU_SIMD_SSE2 : 
+				numUser = extractRowSSE2( row , maskRow , width , user , previous , enable , bounds ) ; 
+				break ; 
+#endif
+			default : 
+				numUser = extractScalar( row , maskRow , 0 , width , user , previous , enable , bounds ) ; 
+				break ; 
+		}
+
+		//Rows are still in cache , count them now
+		histogram.add( row , width ) ; 
+
+		if ( numUser > 0 ) 
+		{
+			if ( result.minY < 0 ) 
+			{
+				result.minY = y ; 
+				result.minX = bounds.minX ; 
+				result.maxX = bounds.maxX ; 
+			}
+			result.maxY = y ; 
+			if ( bounds.minX < result.minX ) result.minX = bounds.minX ; 
+			if ( bounds.maxX > result.maxX ) result.maxX = bounds.maxX ; 
+			result.numUserPixels += numUser ; 
+		}
+	}
+
+	histogram.merge( result.histogram ) ; 
+}
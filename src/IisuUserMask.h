@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+	IisuUserMask
+	One pass over SCENE.LabelImage that produces the user mask ( 255 for the user's labels , 0 elsewhere ) ,
+	the pixel count of every label and the user's bounding box. SSE2 / AVX2 / scalar , picked at runtime.
+*/
+
+#include "IisuCpu.h"
+
+struct IisuUserMaskResult
+{
+	IisuUserMaskResult( ) 
+	{
+		clear( ) ; 
+	}
+
+	void clear( ) 
+	{
+		for ( int i = 0 ; i < 256 ; i++ ) 
+			histogram[i] = 0 ; 
+		numUserPixels = 0 ; 
+		minX = minY = maxX = maxY = -1 ; 
+	}
+
+	bool hasUser( ) const { return ( numUserPixels > 0 ) ; } 
+
+	unsigned int histogram[256] ;		//pixels per label value
+	int numUserPixels ; 
+	int minX , minY , maxX , maxY ;		//inclusive , -1 when there's no user
+};
+
+class IisuUserMask
+{
+	public :
+		//Pixels labelled userID or previousUserID are the user. A userID of 250 or up means nobody is there
+		//and the mask comes out empty , the histogram is filled either way
+		static void extract( const unsigned char * labels , int width , int height , int userID , int previousUserID , 
+							 unsigned char * mask , IisuUserMaskResult &result , IisuSimdLevel level ) ; 
+
+		static void extract( const unsigned char * labels , int width , int height , int userID , int previousUserID , 
+							 unsigned char * mask , IisuUserMaskResult &result ) 
+		{
+			extract( labels , width , height , userID , previousUserID , mask , result , IisuCpu::getSimdLevel() ) ; 
+		}
+};
@@ -11,8 +11,18 @@ void IisuUserRepresentation::setup ( int _w , int _h  )
 	imageHeight = _h ; 
 	pPointerStatus = -3 ; 
 	lastFrame= -4 ; 
-	sceneImage.allocate( imageWidth , imageHeight , OF_IMAGE_GRAYSCALE ) ; 
-	userImage.allocate ( imageWidth , imageHeight , OF_IMAGE_GRAYSCALE ) ; 
+	lastLabelFrameID = -1 ; 
+	lastMaskFrameID = -1 ; 
+	maskUserID = 0 ; 
+	maskPreviousUserID = 0 ; 
+	lastContourFrameID = -1 ; 
+	lastSimplify = -1.0f ; 
+	vectorFillColor = ofColor( 0 , 0 , 0 , 80 ) ; 
+	vectorStrokeColor = ofColor( 255 , 0 , 0 , 165 ) ; 
+	vectorPath.setPolyWindingMode( OF_POLY_WINDING_ODD ) ; 
+	vectorPath.setFilled( true ) ; 
+	labelTexture.allocate( imageWidth , imageHeight ) ; 
+	userMask.assign( imageWidth * imageHeight , 0 ) ; 
 
 	lastUserID = 0 ; 
 		
@@ -22,183 +32,113 @@ void IisuUserRepresentation::setup ( int _w , int _h  )
 
 void IisuUserRepresentation::update ( ) 
 {
+	IISU_PROFILE_SCOPE( IISU_STAGE_USER_REP_UPDATE ) ; 
+	subscription.set( iisu , IISU_STREAM_LABEL_IMAGE ) ; 
 	if ( iisu->getIsConnected() == false ) return ; 
 
-	if ( iisu->sceneImageHandle.isValid() == 1 )
+	int totalPixels = imageWidth * imageHeight ;
+
+	//Live or replayed , the label image lands in the same place
+	const IisuFrame &frame = iisu->getFrame() ; 
+	if ( frame.labelImage.size() >= totalPixels && totalPixels > 0 )
 	{
 
 		//cout << "VALID! " << endl ;
-		int totalPixels = imageWidth * imageHeight ;
-
-		//Awesomely added by Andy Warner
-
-		unsigned char * pRawPixels = iisu->sceneImage.getRAW() ; 
-		memcpy(rawPixels, pRawPixels, totalPixels);
 
 		int userValue = iisu->user1SceneID ; 
-				
-		sceneImage.setFromPixels( rawPixels, sceneImage.width , sceneImage.height , OF_IMAGE_GRAYSCALE , true ) ;
-		sceneImage.mirror( false , true ) ; 
 
-		int maxBrightness = 255; 
-		int minBrightness = 1 ; 
-
-		if ( userValue < 250 ) 
-		{
-			for ( int i = 0 ; i < totalPixels ; i++ ) 
-			{
-				unsigned char value = rawPixels[i] ; 
-				if ( value != userValue && value != lastUserID ) 
-				{
-					rawPixels[i] = 0 ;
-				}
-				else
-					rawPixels[i] = 255 ; 
-			}
-
-			/*
-			cout << "minBrightness : " << ofToString(minBrightness) << " <-> " << ofToString(maxBrightness) << endl ; 
-					
-			if ( minBrightness < maxBrightness )
-			{
-				//Map the colors to somethign that looks cooler
-				for ( int p = 0 ; p < totalPixels ; p++ ) 
-				{
-					rawPixels[p] = ofMap( rawPixels[p] , minBrightness , maxBrightness  , minMappedBrightness , maxMappedBrightness ) ; 
-				}
-			}*/
-		}
-		else
+		//Upload once per iisu frame , straight out of the frame buffer
+		if ( frame.frameID != lastLabelFrameID ) 
 		{
-			for ( int i = 0 ; i < totalPixels ; i++ ) 
-			{
-				rawPixels[i] = 0 ;
-			}
+			labelTexture.loadLabels( &frame.labelImage[0] , imageWidth , imageHeight ) ; 
+			maskUserID = userValue ; 
+			maskPreviousUserID = lastUserID ; 
+			lastLabelFrameID = frame.frameID ; 
 		}
 
-		userImage.setFromPixels( rawPixels, sceneImage.width , sceneImage.height , OF_IMAGE_GRAYSCALE , true ) ;
-		userImage.mirror( false , true ) ; 
+		labelTexture.setUserLabels( userValue , lastUserID ) ; 
 	
 		if ( userValue != lastUserID ) 
 		{
 			lastUserID = userValue ; 
 		}
+	}
+}
 
 
-	//	int totalPixels = imageWidth * imageHeight ;
-	//memcpy(grayPixels , rawPixels, totalPixels );
-		//mutex.lock( ) ; 
-	//grayImage.setFromPixels( rawPixels ,  sceneImage.width , sceneImage.height ) ; 
-	//grayImage.mirror( false , true ) ; 
-	//grayImage.blurGaussian( 11 ) ;
-	//grayImage.flagImageChanged();
-	//contourFinder.findContours( grayImage, 100 , (imageWidth*imageHeight)/3, 1 , true , true );	// find holes
-					
-	}
+void IisuUserRepresentation::updateUserMask( ) 
+{
+	if ( lastMaskFrameID == lastLabelFrameID ) 
+		return ; 
+
+	//Still the frame update() uploaded unless the server moved on since , then the newer labels are just as good
+	const IisuFrame &frame = iisu->getFrame() ; 
+	int totalPixels = imageWidth * imageHeight ; 
+	if ( frame.labelImage.size() < totalPixels || totalPixels <= 0 || userMask.size() < totalPixels ) 
+		return ; 
+
+	IISU_PROFILE_SCOPE( IISU_STAGE_USER_REP_UPDATE ) ; 
+	IisuUserMask::extract( &frame.labelImage[0] , imageWidth , imageHeight , maskUserID , maskPreviousUserID , &userMask[0] , userMaskResult ) ; 
+	lastMaskFrameID = lastLabelFrameID ; 
+}
+
+ofRectangle IisuUserRepresentation::getUserBounds( ) 
+{
+	updateUserMask( ) ; 
+	if ( userMaskResult.hasUser() == false ) 
+		return ofRectangle( ) ; 
+
+	return ofRectangle( userMaskResult.minX , userMaskResult.minY , 
+						userMaskResult.maxX - userMaskResult.minX + 1 , userMaskResult.maxY - userMaskResult.minY + 1 ) ; 
 }
 
+void IisuUserRepresentation::updateContours( float simplify ) 
+{
+	if ( lastContourFrameID == lastLabelFrameID && lastSimplify == simplify ) 
+		return ; 
+
+	if ( lastContourFrameID != lastLabelFrameID && getUserMask().size() > 0 ) 
+		contourTracer.trace( &userMask[0] , imageWidth , imageHeight ) ; 
+	contourTracer.simplify( simplify ) ; 
+	lastContourFrameID = lastLabelFrameID ; 
+	lastSimplify = simplify ; 
+
+	//Label image pixels , drawVectorUserRep scales and mirrors it
+	vectorPath.clear() ; 
+	vectorPath.setFillColor( vectorFillColor ) ; 
+	for ( int i = 0 ; i < contourTracer.simplifiedContours.size() ; i++ ) 
+	{
+		const IisuContour &contour = contourTracer.simplifiedContours[i] ; 
+		const ofPoint * points = &contourTracer.simplifiedPoints[ contour.start ] ; 
+		vectorPath.moveTo( points[0] ) ; 
+		for ( int j = 1 ; j < contour.count ; j++ ) 
+			vectorPath.lineTo( points[j] ) ; 
+		vectorPath.close() ; 
+	}
+}
 
 void IisuUserRepresentation::drawVectorUserRep ( float x , float y , float width , float height , float simplify  ) 
 {
+	if ( imageWidth <= 0 || imageHeight <= 0 ) 
+		return ; 
+	updateContours( simplify ) ; 
+	if ( contourTracer.simplifiedContours.size() == 0 ) 
+		return ; 
+
 	ofPushMatrix() ; 
 		ofPushStyle() ; 
-		ofTranslate( x , y ) ; 
-				
-		/*
-		if ( contourFinder.nBlobs > 0 ) 
-		{
-			ofNoFill ( ) ; 
-			int nBlobs = contourFinder.blobs.size() ; 
-			vector<ofxCvBlob>  blobs = contourFinder.blobs ; 
-			ofRectangle bounds ; 
-
-			for( int i=0; i< nBlobs ; i++ ) {
-
-				bounds = blobs[i].boundingRect ; 
-			}
-					
-			float xRatio = bounds.x / imageWidth ; 
-			float yRatio = bounds.y / imageHeight ; 
-			float wRatio = bounds.width / imageWidth ; 
-			float hRatio = bounds.height / imageHeight ; 
-
-		
-			ofPath path ; 
-			float userRepAlpha = 80 ; 
-			path.setFillColor( ofColor( 0 , 0 , 0 , userRepAlpha ) ) ; 
-			path.setStrokeColor( ofColor ( EmiratesGlobal::Instance()->EMIRATES_RED ,  255 ) ) ;
-			path.setStrokeWidth( 4 ) ; 
-
-			//Convert all openCV points to normalized coordinates within the texture,
-			//this is done so we can scale the points position and place them larger on the screen.
-
-			for( int i=0; i< nBlobs ; i++ ) {
-				ofNoFill();
-				
-				vector<ofPoint> normalizedPoints ; 
-						
-				for( int j=1; j<blobs[i].nPts; j++ )
-				{
-					ofPoint p = ofPoint ( blobs[i].pts[j].x, blobs[i].pts[j].y  ) ; 
-
-					p.x /= imageWidth ;  
-					p.y /= imageHeight ; 
-					normalizedPoints.push_back( p ) ; 
-				}
-			}
-
-
-				//>>>>>>>>>>>>>>>>>>>>>>>BEGIN
-			//ofPath outlinePath ; 
-			ofPolyline line ; 
-			//ofPath path ; 
-
-				for( int i=0; i< nBlobs ; i++ ) {
-				ofNoFill();
-
-				vector<ofPoint> normalizedPoints ; 
-
-				for( int j=1; j<blobs[i].nPts; j++ )
-				{
-					ofPoint p = ofPoint ( blobs[i].pts[j].x, blobs[i].pts[j].y  ) ; 
-
-					p.x /= imageWidth ;  
-					p.y /= imageHeight ; 
-					normalizedPoints.push_back( p ) ; 
-				}
-
-				for( int i = 0 ; i < normalizedPoints.size() ; i++ )
-				{
-					//ofPoint nPoint1 = normalizedPoints[ i - 1 ] ; 
-					ofPoint nPoint1 = normalizedPoints[ i ] ; 
-					nPoint1.x *= width ; 
-					nPoint1.y *= height ; 
-					//nPoint2.x *= width ; 
-					//nPoint2.y *= height ; 
-
-					//ofPoint mid = ( nPoint1 + nPoint2 ) / 2 ;  
-				//	line.bezierTo( nPoint1 , nPoint2 , mid , 16 ) ; 
-					line.lineTo( nPoint1.x , nPoint1.y  ) ;   
-				}
-
-				line.close( ) ; 
-				//line.close( ) ;
-						
-
-			}
-				
-					
-			ofSetColor ( EmiratesGlobal::Instance()->EMIRATES_RED , 165 ) ; 
-			ofSetLineWidth( 6 ) ; 
-			ofFill ( ) ; 
-			
-			ofPushMatrix( ) ;
-				line.getSmoothed( simplify ).draw( ) ;
-			ofPopMatrix( ) ; 
-			glPopMatrix();
-			ofPopStyle();
-						
-		}*/
+		//Mirrored like the label texture
+		ofTranslate( x + width , y ) ; 
+		ofScale( -width / imageWidth , height / imageHeight ) ; 
+
+		vectorPath.draw( ) ; 
+
+		//Outlines come out of the same tessellation , no second path
+		const vector<ofPolyline> &outlines = vectorPath.getOutline() ; 
+		ofSetColor( vectorStrokeColor ) ; 
+		ofSetLineWidth( 4 ) ; 
+		for ( int i = 0 ; i < outlines.size() ; i++ ) 
+			outlines[i].draw( ) ; 
 		ofPopStyle( ) ; 
 
 	ofPopMatrix() ; 
@@ -213,10 +153,10 @@ void IisuUserRepresentation::draw ( float x , float y , float width , float heig
 		ofPushStyle() ; 
 	
 			ofSetColor( 0 , 0 , 255 , 100 ) ; 
-			sceneImage.draw ( x , y , width , height ) ;
+			labelTexture.drawScene ( x , y , width , height ) ;
 			ofEnableBlendMode( OF_BLENDMODE_ADD ) ; 
 			ofSetColor( 0 , 255 , 0 , 255 ) ;
-			userImage.draw( x , y , width , height  ) ; 
+			labelTexture.drawUser( x , y , width , height  ) ; 
 			ofEnableBlendMode( OF_BLENDMODE_ALPHA ) ; 
 
 		ofPopStyle() ;
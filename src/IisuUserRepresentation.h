@@ -3,13 +3,9 @@
 
 #include "IisuServer.h" 
 #include "ofMain.h" 
-
-//Still working on the openCV stuff
-//#include "ofxOpenCv.h"
-
-#include "ofThread.h"
-
-static ofMutex myMutex ;
+#include "IisuLabelTexture.h"
+#include "IisuUserMask.h"
+#include "IisuContour.h"
 
 enum POINTER_STATUS
 {
@@ -29,16 +25,27 @@ class IisuUserRepresentation
 
 		void setup ( int _w = 160 , int _h = 120 ) ;
 		void update ( ) ;
+		//Outline of userMask , holes included. simplify is the Douglas-Peucker tolerance in label image pixels
 		void drawVectorUserRep ( float x , float y , float width , float height , float simplify  ) ;
 		void draw ( float x , float y , float width , float height ) ;
 			
 		IisuServer * iisu ; 
+		IisuSubscription subscription ;		//SCENE.LabelImage , taken in update()
 		
-		ofImage sceneImage ; 
-		ofImage userImage ; 
+		//SCENE.LabelImage on the GPU , the user mask and mirroring happen when it's drawn
+		IisuLabelTexture labelTexture ; 
+		int lastLabelFrameID ; 
 
-		unsigned char rawPixels[120 * 160];
-		unsigned char grayPixels[120 * 160];
+		//CPU side of the same mask , plus pixels per label and where the user is. Only extracted when something
+		//asks for it , at most once per label image , so drawing the texture alone never walks the pixels
+		const vector<unsigned char>& getUserMask( ) { updateUserMask( ) ; return userMask ; } 
+		const IisuUserMaskResult& getUserMaskResult( ) { updateUserMask( ) ; return userMaskResult ; } 
+		ofRectangle getUserBounds( ) ;			//in label image pixels , empty when there's no user
+		void updateUserMask( ) ; 
+		vector<unsigned char> userMask ;		//as of the last getUserMask() / getUserBounds() / drawVectorUserRep()
+		IisuUserMaskResult userMaskResult ; 
+		int lastMaskFrameID ; 
+		int maskUserID , maskPreviousUserID ;	//the labels update() saw for lastLabelFrameID
 
 		int lastUserID ; 
 		string status ; 
@@ -50,9 +57,13 @@ class IisuUserRepresentation
 
 		int pPointerStatus ; 
  
-		//OpenCV to get vector outlines
-		//ofxCvGrayscaleImage 	grayImage;
-		//ofxCvContourFinder 		contourFinder;
+		//Vector outlines , traced again only when the mask or the tolerance changed
+		IisuContourTracer contourTracer ; 
+		ofPath vectorPath ; 
+		int lastContourFrameID ; 
+		float lastSimplify ; 
+		ofColor vectorFillColor , vectorStrokeColor ; 
+		void updateContours( float simplify ) ; 
 		
 		int imageWidth , imageHeight ; 
 
@@ -1,5 +1,14 @@
 #include "IisuUtils.h"
 
+#ifdef IISU_X86
+#include <xmmintrin.h>
+#endif
+#include <float.h>
+
+//apply() reads Vector3 arrays as packed floats
+typedef char IisuVector3IsPacked[ ( sizeof( Vector3 ) == 3 * sizeof( float ) ) ? 1 : -1 ] ; 
+typedef char IisuVector2IsPacked[ ( sizeof( Vector2 ) == 2 * sizeof( float ) ) ? 1 : -1 ] ; 
+
 
 ofVec3f IisuUtils::iisuPointToOF( Vector3 point )
 {
@@ -103,3 +112,287 @@ Vector2 IisuUtils::normalize2DPoint( Vector2 v , float w , float h , bool bMirro
 
 	return Vector2( newX , newY ) ;  
 }
+
+IisuAffineTransform IisuUtils::getPosition3DToOfxScreenTransform( ofRectangle bounds , bool mirrorX , bool mirrorY ) 
+{
+	//x = bounds.x + ( x + 1 ) / factorX * width , y = bounds.y + height - ( z + 1 ) / factorY * height , z = y
+	float scaleX = bounds.width / ( mirrorX ? -2.0f : 2.0f ) ; 
+	float scaleY = bounds.height / ( mirrorY ? -2.0f : 2.0f ) ; 
+
+	IisuAffineTransform transform ; 
+	transform.setRow( 0 , scaleX , 0 , 0 , bounds.x + scaleX ) ; 
+	transform.setRow( 1 , 0 , 0 , -scaleY , bounds.y + bounds.height - scaleY ) ; 
+	transform.setRow( 2 , 0 , 1 , 0 , 0 ) ; 
+	return transform ; 
+}
+
+void IisuAffineTransform::setIdentity( ) 
+{
+	for ( int r = 0 ; r < 3 ; r++ ) 
+		for ( int c = 0 ; c < 4 ; c++ ) 
+			m[r][c] = ( r == c ) ? 1.0f : 0.0f ; 
+}
+
+void IisuAffineTransform::setRow( int row , float ax , float ay , float az , float t ) 
+{
+	m[row][0] = ax ; 
+	m[row][1] = ay ; 
+	m[row][2] = az ; 
+	m[row][3] = t ; 
+}
+
+void IisuAffineTransform::translateInput( float tx , float ty , float tz ) 
+{
+	for ( int r = 0 ; r < 3 ; r++ ) 
+		m[r][3] += m[r][0] * tx + m[r][1] * ty + m[r][2] * tz ; 
+}
+
+ofVec3f IisuAffineTransform::apply( const Vector3 &p ) const 
+{
+	return ofVec3f( m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3] , 
+					m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3] , 
+					m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3] ) ; 
+}
+
+void IisuAffineTransform::apply( const Vector3 * points , int count , float * x , float * y , float * z , IisuSimdLevel level ) const 
+{
+	int i = 0 ; 
+
+#ifdef IISU_X86
+	if ( level >= IISU_SIMD_SSE2 ) 
+	{
+		__m128 row[3][4] ; 
+		for ( int r = 0 ; r < 3 ; r++ ) 
+			for ( int c = 0 ; c < 4 ; c++ ) 
+				row[r][c] = _mm_set1_ps( m[r][c] ) ; 
+
+		const float * in = (const float *) points ; 
+		for ( ; i + 4 <= count ; i += 4 ) 
+		{
+			//Four packed points x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 turned into x , y and z lanes
+			__m128 a = _mm_loadu_ps( in + i * 3 ) ; 
+			__m128 b = _mm_loadu_ps( in + i * 3 + 4 ) ; 
+			__m128 c = _mm_loadu_ps( in + i * 3 + 8 ) ; 
+
+			__m128 px = _mm_shuffle_ps( a , _mm_shuffle_ps( b , c , _MM_SHUFFLE( 1 , 1 , 2 , 2 ) ) , _MM_SHUFFLE( 2 , 0 , 3 , 0 ) ) ; 
+			__m128 py = _mm_shuffle_ps( _mm_shuffle_ps( a , b , _MM_SHUFFLE( 0 , 0 , 1 , 1 ) ) , _mm_shuffle_ps( b , c , _MM_SHUFFLE( 2 , 2 , 3 , 3 ) ) , _MM_SHUFFLE( 2 , 0 , 2 , 0 ) ) ; 
+			__m128 pz = _mm_shuffle_ps( _mm_shuffle_ps( a , b , _MM_SHUFFLE( 1 , 1 , 2 , 2 ) ) , _mm_shuffle_ps( c , c , _MM_SHUFFLE( 3 , 3 , 0 , 0 ) ) , _MM_SHUFFLE( 2 , 0 , 2 , 0 ) ) ; 
+
+			float * out[3] = { x + i , y + i , z + i } ; 
+			for ( int r = 0 ; r < 3 ; r++ ) 
+			{
+				__m128 v = _mm_add_ps( _mm_mul_ps( row[r][0] , px ) , row[r][3] ) ; 
+				v = _mm_add_ps( v , _mm_mul_ps( row[r][1] , py ) ) ; 
+				v = _mm_add_ps( v , _mm_mul_ps( row[r][2] , pz ) ) ; 
+				_mm_storeu_ps( out[r] , v ) ; 
+			}
+		}
+	}
+#endif
+
+	for ( ; i < count ; i++ ) 
+	{
+		const Vector3 &p = points[i] ; 
+		x[i] = m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3] ; 
+		y[i] = m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3] ; 
+		z[i] = m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3] ; 
+	}
+}
+
+//ofMap( v , inMin , inMax , outMin , outMax ) as out = v * scale + offset , including its divide by zero guard
+static void rangeToScale( float inMin , float inMax , float outMin , float outMax , float &scale , float &offset ) 
+{
+	if ( fabs( inMin - inMax ) < FLT_EPSILON ) 
+	{
+		scale = 0.0f ; 
+		offset = outMin ; 
+		return ; 
+	}
+
+	scale = ( outMax - outMin ) / ( inMax - inMin ) ; 
+	offset = outMin - inMin * scale ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::iisuPointToOF( float width , float height ) 
+{
+	IisuAffineTransform transform ; 
+	transform.setRow( 0 , width * 0.5f , 0 , 0 , width * 0.5f ) ; 
+	transform.setRow( 1 , 0 , 0 , -height * 0.5f , height * 0.5f ) ; 
+	transform.setRow( 2 , 0 , 1 , 0 , 0 ) ; 
+	return IisuCoordinateMapper( transform ) ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::iisuPointToOF( ofVec3f range ) 
+{
+	IisuAffineTransform transform ; 
+	transform.setRow( 0 , range.x * 0.5f , 0 , 0 , range.x * 0.5f ) ; 
+	transform.setRow( 1 , 0 , 0 , range.y * 0.5f , range.y * 0.5f ) ; 
+	transform.setRow( 2 , 0 , range.z , 0 , 0 ) ; 
+	return IisuCoordinateMapper( transform ) ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::iisuPosition3DToOfxScreen( ofRectangle bounds , bool mirrorX , bool mirrorY ) 
+{
+	return IisuCoordinateMapper( IisuUtils::getPosition3DToOfxScreenTransform( bounds , mirrorX , mirrorY ) ) ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::iisuPosition3DToOfxScreen( ofPoint scale , bool mirrorX , bool mirrorY ) 
+{
+	IisuAffineTransform transform ; 
+	transform.setRow( 0 , ( mirrorX ? -1.0f : 1.0f ) * scale.x , 0 , 0 , 0 ) ; 
+	transform.setRow( 1 , 0 , 0 , ( mirrorY ? -1.0f : 1.0f ) * scale.y , 0 ) ; 
+	transform.setRow( 2 , 0 , scale.z , 0 , 0 ) ; 
+	return IisuCoordinateMapper( transform ) ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::iisuPosition3DToOfxScreen( float width , float height , float paddingRatio , bool bMirror , bool bKeepWithinBounds ) 
+{
+	//Both screen axes take the mirror , like the single point version
+	float mirrorFactor = bMirror ? -1.0f : 1.0f ; 
+	float scaleX , offsetX , scaleY , offsetY ; 
+	rangeToScale( -paddingRatio , paddingRatio , width * -paddingRatio , width * ( 1 + paddingRatio ) , scaleX , offsetX ) ; 
+	rangeToScale( -paddingRatio , paddingRatio , height * -paddingRatio , height * ( 1 + paddingRatio ) , scaleY , offsetY ) ; 
+
+	IisuAffineTransform transform ; 
+	transform.setRow( 0 , mirrorFactor * scaleX , 0 , 0 , offsetX ) ; 
+	transform.setRow( 1 , 0 , 0 , mirrorFactor * scaleY , offsetY ) ; 
+	transform.setRow( 2 , 0 , 1 , 0 , 0 ) ; 
+
+	IisuCoordinateMapper mapper( transform ) ; 
+	if ( bKeepWithinBounds ) 
+		mapper.setClamp( 0 , 0 , width , height ) ; 
+	return mapper ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::iisuPosition2DToOfxScreen( float width , float height , float paddingRatio , bool bMirror , bool bKeepWithinBounds ) 
+{
+	float mirrorFactor = bMirror ? -1.0f : 1.0f ; 
+	float scaleX , offsetX , scaleY , offsetY ; 
+	rangeToScale( -paddingRatio , paddingRatio , width * -paddingRatio , width * ( 1 + paddingRatio ) , scaleX , offsetX ) ; 
+	rangeToScale( -paddingRatio , paddingRatio , height * -paddingRatio , height * ( 1 + paddingRatio ) , scaleY , offsetY ) ; 
+
+	IisuAffineTransform transform ; 
+	transform.setRow( 0 , mirrorFactor * scaleX , 0 , 0 , offsetX ) ; 
+	transform.setRow( 1 , 0 , mirrorFactor * scaleY , 0 , offsetY ) ; 
+	transform.setRow( 2 , 0 , 0 , 0 , 0 ) ; 
+
+	IisuCoordinateMapper mapper( transform ) ; 
+	if ( bKeepWithinBounds ) 
+		mapper.setClamp( 0 , 0 , width , height ) ; 
+	return mapper ; 
+}
+
+IisuCoordinateMapper IisuCoordinateMapper::normalize2DPoint( float w , float h , bool bMirrorX , bool bMirrorY , float width , float height ) 
+{
+	IisuAffineTransform transform ; 
+	if ( bMirrorX ) 
+		transform.setRow( 0 , -width / w , 0 , 0 , width ) ; 
+	else
+		transform.setRow( 0 , width / w , 0 , 0 , 0 ) ; 
+
+	if ( bMirrorY ) 
+		transform.setRow( 1 , 0 , -height / h , 0 , height ) ; 
+	else
+		transform.setRow( 1 , 0 , height / h , 0 , 0 ) ; 
+
+	transform.setRow( 2 , 0 , 0 , 0 , 0 ) ; 
+	return IisuCoordinateMapper( transform ) ; 
+}
+
+void IisuCoordinateMapper::setClamp( float minX , float minY , float maxX , float maxY ) 
+{
+	bClamp = true ; 
+	clampMin[0] = minX ; 
+	clampMin[1] = minY ; 
+	clampMax[0] = maxX ; 
+	clampMax[1] = maxY ; 
+}
+
+ofVec3f IisuCoordinateMapper::map( const Vector3 &point ) const 
+{
+	ofVec3f p = transform.apply( point ) ; 
+	if ( bClamp ) 
+	{
+		p.x = MIN( MAX( p.x , clampMin[0] ) , clampMax[0] ) ; 
+		p.y = MIN( MAX( p.y , clampMin[1] ) , clampMax[1] ) ; 
+	}
+	return p ; 
+}
+
+ofVec2f IisuCoordinateMapper::map( const Vector2 &point ) const 
+{
+	const float ( &m )[3][4] = transform.m ; 
+	ofVec2f p( m[0][0] * point.x + m[0][1] * point.y + m[0][3] , 
+			   m[1][0] * point.x + m[1][1] * point.y + m[1][3] ) ; 
+	if ( bClamp ) 
+	{
+		p.x = MIN( MAX( p.x , clampMin[0] ) , clampMax[0] ) ; 
+		p.y = MIN( MAX( p.y , clampMin[1] ) , clampMax[1] ) ; 
+	}
+	return p ; 
+}
+
+void IisuCoordinateMapper::map( const Vector3 * points , int count , float * x , float * y , float * z , IisuSimdLevel level ) const 
+{
+	transform.apply( points , count , x , y , z , level ) ; 
+	if ( bClamp == false ) 
+		return ; 
+
+	int i = 0 ; 
+#ifdef IISU_X86
+	if ( level >= IISU_SIMD_SSE2 ) 
+	{
+		__m128 minX = _mm_set1_ps( clampMin[0] ) , maxX = _mm_set1_ps( clampMax[0] ) ; 
+		__m128 minY = _mm_set1_ps( clampMin[1] ) , maxY = _mm_set1_ps( clampMax[1] ) ; 
+		for ( ; i + 4 <= count ; i += 4 ) 
+		{
+			_mm_storeu_ps( x + i , _mm_min_ps( _mm_max_ps( _mm_loadu_ps( x + i ) , minX ) , maxX ) ) ; 
+			_mm_storeu_ps( y + i , _mm_min_ps( _mm_max_ps( _mm_loadu_ps( y + i ) , minY ) , maxY ) ) ; 
+		}
+	}
+#endif
+	for ( ; i < count ; i++ ) 
+	{
+		x[i] = MIN( MAX( x[i] , clampMin[0] ) , clampMax[0] ) ; 
+		y[i] = MIN( MAX( y[i] , clampMin[1] ) , clampMax[1] ) ; 
+	}
+}
+
+void IisuCoordinateMapper::map( const Vector2 * points , int count , float * x , float * y , IisuSimdLevel level ) const 
+{
+	const float ( &m )[3][4] = transform.m ; 
+	int i = 0 ; 
+
+#ifdef IISU_X86
+	if ( level >= IISU_SIMD_SSE2 ) 
+	{
+		__m128 m00 = _mm_set1_ps( m[0][0] ) , m01 = _mm_set1_ps( m[0][1] ) , m03 = _mm_set1_ps( m[0][3] ) ; 
+		__m128 m10 = _mm_set1_ps( m[1][0] ) , m11 = _mm_set1_ps( m[1][1] ) , m13 = _mm_set1_ps( m[1][3] ) ; 
+		__m128 minX = _mm_set1_ps( bClamp ? clampMin[0] : -FLT_MAX ) , maxX = _mm_set1_ps( bClamp ? clampMax[0] : FLT_MAX ) ; 
+		__m128 minY = _mm_set1_ps( bClamp ? clampMin[1] : -FLT_MAX ) , maxY = _mm_set1_ps( bClamp ? clampMax[1] : FLT_MAX ) ; 
+
+		const float * in = (const float *) points ; 
+		for ( ; i + 4 <= count ; i += 4 ) 
+		{
+			//x0 y0 x1 y1 | x2 y2 x3 y3
+			__m128 a = _mm_loadu_ps( in + i * 2 ) ; 
+			__m128 b = _mm_loadu_ps( in + i * 2 + 4 ) ; 
+			__m128 px = _mm_shuffle_ps( a , b , _MM_SHUFFLE( 2 , 0 , 2 , 0 ) ) ; 
+			__m128 py = _mm_shuffle_ps( a , b , _MM_SHUFFLE( 3 , 1 , 3 , 1 ) ) ; 
+
+			__m128 ox = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m00 , px ) , _mm_mul_ps( m01 , py ) ) , m03 ) ; 
+			__m128 oy = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m10 , px ) , _mm_mul_ps( m11 , py ) ) , m13 ) ; 
+			_mm_storeu_ps( x + i , _mm_min_ps( _mm_max_ps( ox , minX ) , maxX ) ) ; 
+			_mm_storeu_ps( y + i , _mm_min_ps( _mm_max_ps( oy , minY ) , maxY ) ) ; 
+		}
+	}
+#endif
+
+	for ( ; i < count ; i++ ) 
+	{
+		ofVec2f p = map( points[i] ) ; 
+		x[i] = p.x ; 
+		y[i] = p.y ; 
+	}
+}
+
@@ -11,6 +11,9 @@ using namespace SK;
 using namespace std;
 
 #include "ofMain.h" 
+#include "IisuCpu.h"
+
+class IisuAffineTransform ; 
 
 class IisuUtils 
 {
@@ -35,5 +38,72 @@ class IisuUtils
 		ofVec3f Vector3DToPoint( Vector3 v ) { return ofVec3f ( v.x , v.z , v.y ) ; } 
 		ofVec2f Vector2DToPoint( Vector2 v ) { return ofVec2f ( v.x , v.y ) ; } 
 		Vector2 normalize2DPoint( Vector2 v , float w , float h , bool bMirrorX = false , bool bMirrorY = false ) ;
+
+		//iisuPosition3DToOfxScreen( point , bounds , mirrorX , mirrorY ) as a matrix
+		static IisuAffineTransform getPosition3DToOfxScreenTransform( ofRectangle bounds , bool mirrorX = false , bool mirrorY = false ) ; 
 		
-};
\ No newline at end of file
+};
+
+//3 x 4 affine transform run over whole arrays of iisu points. Row i maps ( x , y , z , 1 ) to output axis i ,
+//so axis swaps , mirroring , scaling and offsets all fold into one matrix built once per frame
+class IisuAffineTransform
+{
+	public :
+		IisuAffineTransform( ) { setIdentity( ) ; } 
+
+		void setIdentity( ) ; 
+		void setRow( int row , float ax , float ay , float az , float t ) ; 
+		void translateInput( float tx , float ty , float tz ) ;		//same as adding ( tx , ty , tz ) to every point first
+
+		ofVec3f apply( const Vector3 &point ) const ; 
+
+		//Output is structure of arrays and must not overlap the input
+		void apply( const Vector3 * points , int count , float * x , float * y , float * z , IisuSimdLevel level ) const ; 
+		void apply( const Vector3 * points , int count , float * x , float * y , float * z ) const 
+		{
+			apply( points , count , x , y , z , IisuCpu::getSimdLevel() ) ; 
+		}
+
+		float m[3][4] ; 
+};
+
+//Maps whole spans of iisu points into a viewport. Build it once when the viewport or calibration changes ,
+//mirroring , padding and the min / max clamp are all folded in so mapping a point is a multiply add and a clamp
+class IisuCoordinateMapper
+{
+	public :
+		IisuCoordinateMapper( ) { bClamp = false ; } 
+		IisuCoordinateMapper( const IisuAffineTransform &_transform ) 
+		{
+			transform = _transform ; 
+			bClamp = false ; 
+		}
+
+		//Same results as the IisuUtils functions of the same name , for a width x height viewport
+		static IisuCoordinateMapper iisuPointToOF( float width , float height ) ; 
+		static IisuCoordinateMapper iisuPointToOF( ofVec3f range ) ; 
+		static IisuCoordinateMapper iisuPosition3DToOfxScreen( ofRectangle bounds , bool mirrorX = false , bool mirrorY = false ) ; 
+		static IisuCoordinateMapper iisuPosition3DToOfxScreen( ofPoint scale , bool mirrorX = false , bool mirrorY = false ) ; 
+		static IisuCoordinateMapper iisuPosition3DToOfxScreen( float width , float height , float paddingRatio = 0.0f , bool bMirror = true , bool bKeepWithinBounds = true ) ; 
+		static IisuCoordinateMapper iisuPosition2DToOfxScreen( float width , float height , float paddingRatio = 0.0f , bool bMirror = true , bool bKeepWithinBounds = true ) ; 
+		//normalize2DPoint( v , w , h , ... ) scaled up to the viewport
+		static IisuCoordinateMapper normalize2DPoint( float w , float h , bool bMirrorX , bool bMirrorY , float width = 1.0f , float height = 1.0f ) ; 
+
+		//Keeps the output x / y inside the rectangle
+		void setClamp( float minX , float minY , float maxX , float maxY ) ; 
+		void disableClamp( ) { bClamp = false ; } 
+
+		//Vector2 input uses x / y and ignores the z column , Vector3 uses all three
+		void map( const Vector3 * points , int count , float * x , float * y , float * z , IisuSimdLevel level ) const ; 
+		void map( const Vector2 * points , int count , float * x , float * y , IisuSimdLevel level ) const ; 
+		void map( const Vector3 * points , int count , float * x , float * y , float * z ) const { map( points , count , x , y , z , IisuCpu::getSimdLevel() ) ; } 
+		void map( const Vector2 * points , int count , float * x , float * y ) const { map( points , count , x , y , IisuCpu::getSimdLevel() ) ; } 
+
+		ofVec3f map( const Vector3 &point ) const ; 
+		ofVec2f map( const Vector2 &point ) const ; 
+
+		IisuAffineTransform transform ; 
+		bool bClamp ; 
+		float clampMin[2] , clampMax[2] ; 
+};
+
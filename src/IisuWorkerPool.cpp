@@ -0,0 +1,123 @@
+#include "IisuWorkerPool.h"
+
+void IisuWorkerThread::threadedFunction( )
+{
+	long seenBatch = 0 ; 
+	while ( isThreadRunning() && pool->waitForBatch( seenBatch ) )
+	{
+		//Chunks until the batch runs dry , run() finishes whatever we don't get to
+		while ( pool->work() ) 
+			; 
+	}
+}
+
+IisuWorkerPool::IisuWorkerPool( )
+{
+	ticket = 0 ; 
+	numDone = 0 ; 
+	job = NULL ; 
+	numItems = 0 ; 
+	itemsPerChunk = 1 ; 
+	generation = 0 ; 
+	numBatches = 0 ; 
+	bStopping = false ; 
+}
+
+IisuWorkerPool::~IisuWorkerPool( )
+{
+	stop( ) ; 
+}
+
+void IisuWorkerPool::setup( int numThreads )
+{
+	stop( ) ; 
+	for ( int i = 0 ; i < numThreads ; i++ )
+	{
+		IisuWorkerThread * thread = new IisuWorkerThread( ) ; 
+		thread->pool = this ; 
+		thread->startThread( true , false ) ; 
+		threads.push_back( thread ) ; 
+	}
+}
+
+void IisuWorkerPool::stop( )
+{
+	wakeMutex.lock() ; 
+	bStopping = true ; 
+	wakeCondition.broadcast() ; 
+	wakeMutex.unlock() ; 
+
+	for ( int i = 0 ; i < threads.size() ; i++ )
+		threads[i]->stopThread( ) ; 
+	for ( int i = 0 ; i < threads.size() ; i++ )
+	{
+		threads[i]->waitForThread( false ) ; 
+		delete threads[i] ; 
+	}
+	threads.clear() ; 
+
+	wakeMutex.lock() ; 
+	bStopping = false ; 
+	wakeMutex.unlock() ; 
+}
+
+void IisuWorkerPool::run( IisuWorkerJob * _job , int _numItems )
+{
+	if ( _job == NULL || _numItems <= 0 )
+		return ; 
+
+	//A few chunks per thread so a slow one doesn't hold everybody up
+	int numChunks = MIN( _numItems , MIN( ( (int) threads.size() + 1 ) * 4 , (int) MAX_CHUNKS ) ) ; 
+	itemsPerChunk = ( _numItems + numChunks - 1 ) / numChunks ; 
+	numChunks = ( _numItems + itemsPerChunk - 1 ) / itemsPerChunk ; 
+
+	job = _job ; 
+	numItems = _numItems ; 
+	iisuAtomicStore( &numDone , 0 ) ; 
+	generation = ( generation + 1 ) & 0x7f ; 
+	iisuAtomicStore( &ticket , ( generation << 24 ) | ( numChunks << 12 ) ) ; 
+
+	if ( threads.size() > 0 )
+	{
+		wakeMutex.lock() ; 
+		numBatches++ ; 
+		wakeCondition.broadcast() ; 
+		wakeMutex.unlock() ; 
+	}
+
+	//Help out , then spin on the chunks still running on other threads
+	while ( iisuAtomicLoad( &numDone ) < numChunks )
+		work( ) ; 
+
+	//Nothing left to claim until the next batch
+	iisuAtomicStore( &ticket , ( generation << 24 ) ) ; 
+}
+
+bool IisuWorkerPool::work( )
+{
+	long current = iisuAtomicLoad( &ticket ) ; 
+	long numChunks = ( current >> 12 ) & 0xfff ; 
+	long chunk = current & 0xfff ; 
+	if ( chunk >= numChunks )
+		return false ; 
+	if ( iisuAtomicCompareAndSwap( &ticket , current , current + 1 ) == false )
+		return true ; 
+
+	//The batch can't move on before this chunk is counted , so job and sizes are the ones it was claimed for
+	int first = chunk * itemsPerChunk ; 
+	int count = MIN( itemsPerChunk , numItems - first ) ; 
+	job->runItems( first , count ) ; 
+	iisuAtomicAdd( &numDone , 1 ) ; 
+	return true ; 
+}
+
+bool IisuWorkerPool::waitForBatch( long &seenBatch )
+{
+	wakeMutex.lock() ; 
+	while ( numBatches == seenBatch && bStopping == false )
+		wakeCondition.wait( wakeMutex ) ; 
+	seenBatch = numBatches ; 
+	bool bRun = ( bStopping == false ) ; 
+	wakeMutex.unlock() ; 
+	return bRun ; 
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+	IisuWorkerPool
+	A few ofThreads that share out the items of one batch at a time. run() blocks the calling thread until the
+	batch is done and works on it too , so a pool with no threads ( or threads that are still waking up ) just
+	runs everything inline. Items are handed out in chunks through one atomic ticket , nothing locks while a batch
+	runs. Between batches the threads sleep on a condition run() signals , they don't poll.
+*/
+
+#include "ofMain.h"
+#include "Poco/Condition.h"
+#include "IisuAtomic.h"
+
+//Whatever the batch does , called from any of the pool's threads and the one that called run()
+class IisuWorkerJob
+{
+	public :
+		virtual ~IisuWorkerJob( ) { }
+		virtual void runItems( int first , int count ) = 0 ; 
+}; 
+
+class IisuWorkerPool ; 
+
+class IisuWorkerThread : public ofThread
+{
+	public :
+		IisuWorkerThread( ) { pool = NULL ; }
+		IisuWorkerPool * pool ; 
+
+	protected :
+		void threadedFunction( ) ; 
+}; 
+
+class IisuWorkerPool
+{
+	public :
+		IisuWorkerPool( ) ; 
+		~IisuWorkerPool( ) ; 
+
+		//0 runs every batch on the calling thread
+		void setup( int numThreads ) ; 
+		void stop( ) ; 
+		int getNumThreads( ) { return threads.size() ; }
+
+		void run( IisuWorkerJob * job , int numItems ) ; 
+
+		//Claims and runs one chunk of the current batch , false if there was none left
+		bool work( ) ; 
+
+		//Pool threads park here until a batch newer than seenBatch starts or the pool stops. false when stopping
+		bool waitForBatch( long &seenBatch ) ; 
+
+	protected :
+		//ticket = generation << 24 | numChunks << 12 | next chunk , so a claim is only good for the batch it was made in
+		enum { MAX_CHUNKS = 4095 } ; 
+		iisu_atomic_t ticket ; 
+		iisu_atomic_t numDone ; 
+		IisuWorkerJob * job ; 
+		int numItems ; 
+		int itemsPerChunk ; 
+		long generation ; 
+
+		//Wakes the parked threads , numBatches counts run() calls so a wake up can't be missed
+		ofMutex wakeMutex ; 
+		Poco::Condition wakeCondition ; 
+		long numBatches ; 
+		bool bStopping ; 
+
+		vector<IisuWorkerThread*> threads ; 
+}; 
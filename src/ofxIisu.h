@@ -3,8 +3,12 @@
 
 #include "IisuServer.h" 
 #include "IisuEvents.h" 
+#include "IisuFrameSource.h"
+#include "IisuRecording.h"
+#include "IisuProfiler.h"
 #include "DepthCursor.h"
 #include "HandCursor.h"
+#include "IisuHoverTargets.h"
 #include "IisuUserRepresentation.h"
 
 #endif ; 
\ No newline at end of file